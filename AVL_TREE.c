@@ -1,5 +1,12 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h> // For sysconf, read, write, lseek
+#include <sys/stat.h> // For fstat
 
 typedef struct AVLNode {
     int key;
@@ -200,6 +207,685 @@ AVLNode* deleteNode(AVLNode* root, int key) {
     return root;
 }
 
+// Maximum AVL height is about 1.44*log2(n), so 96 covers any n that fits in memory
+#define MAX_HEIGHT 96
+
+// Point the parent of path[i] (or the root) at a rebalanced subtree
+static void relink(AVLNode** root, AVLNode* path[], int i, AVLNode* oldChild, AVLNode* newChild) {
+    if (i == 0)
+        *root = newChild;
+    else if (path[i - 1]->left == oldChild)
+        path[i - 1]->left = newChild;
+    else
+        path[i - 1]->right = newChild;
+}
+
+// Insert without recursion. Retracing walks the saved path bottom-up and
+// stops as soon as a subtree keeps its old height: after an insert that is
+// either the first unchanged ancestor or the (single) rotation site.
+AVLNode* insertIterative(AVLNode* root, int key) {
+    AVLNode* path[MAX_HEIGHT];
+    int depth = 0;
+
+    // 1. Walk down, remembering the path
+    AVLNode* current = root;
+    while (current != NULL) {
+        if (key == current->key) // Duplicate keys not allowed
+            return root;
+        path[depth++] = current;
+        current = (key < current->key) ? current->left : current->right;
+    }
+
+    AVLNode* node = createNode(key);
+    if (depth == 0) return node;
+    if (key < path[depth - 1]->key)
+        path[depth - 1]->left = node;
+    else
+        path[depth - 1]->right = node;
+
+    // 2. Retrace until the height stops changing
+    for (int i = depth - 1; i >= 0; i--) {
+        AVLNode* n = path[i];
+        int oldHeight = n->height;
+        updateHeight(n);
+        int balance = getBalance(n);
+
+        if (balance > 1) {
+            if (key > n->left->key) // Left Right Case
+                n->left = leftRotate(n->left);
+            relink(&root, path, i, n, rightRotate(n));
+            break; // Rotation restores the pre-insert height
+        }
+        if (balance < -1) {
+            if (key < n->right->key) // Right Left Case
+                n->right = rightRotate(n->right);
+            relink(&root, path, i, n, leftRotate(n));
+            break;
+        }
+        if (n->height == oldHeight)
+            break;
+    }
+    return root;
+}
+
+// Delete without recursion. Unlike insert, a rotation can shorten the
+// subtree, so retracing continues past rotations but still stops at the
+// first ancestor whose height is unchanged.
+AVLNode* deleteIterative(AVLNode* root, int key) {
+    AVLNode* path[MAX_HEIGHT];
+    int depth = 0;
+
+    // 1. Find the node, remembering the path
+    AVLNode* target = root;
+    while (target != NULL && target->key != key) {
+        path[depth++] = target;
+        target = (key < target->key) ? target->left : target->right;
+    }
+    if (target == NULL) return root;
+
+    // Node with two children: remove the inorder successor instead
+    if (target->left != NULL && target->right != NULL) {
+        path[depth++] = target;
+        AVLNode* successor = target->right;
+        while (successor->left != NULL) {
+            path[depth++] = successor;
+            successor = successor->left;
+        }
+        target->key = successor->key;
+        target = successor;
+    }
+
+    // 2. Unlink the node (it has at most one child now)
+    AVLNode* child = (target->left != NULL) ? target->left : target->right;
+    if (depth == 0)
+        root = child;
+    else if (path[depth - 1]->left == target)
+        path[depth - 1]->left = child;
+    else
+        path[depth - 1]->right = child;
+    free(target);
+
+    // 3. Retrace until the height stops changing
+    for (int i = depth - 1; i >= 0; i--) {
+        AVLNode* n = path[i];
+        int oldHeight = n->height;
+        updateHeight(n);
+        int balance = getBalance(n);
+
+        if (balance > 1) {
+            if (getBalance(n->left) < 0) // Left Right Case
+                n->left = leftRotate(n->left);
+            AVLNode* top = rightRotate(n);
+            relink(&root, path, i, n, top);
+            n = top;
+        } else if (balance < -1) {
+            if (getBalance(n->right) > 0) // Right Left Case
+                n->right = rightRotate(n->right);
+            AVLNode* top = leftRotate(n);
+            relink(&root, path, i, n, top);
+            n = top;
+        }
+        if (n->height == oldHeight)
+            break;
+    }
+    return root;
+}
+
+// Free every node
+void freeTree(AVLNode* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+// Time n inserts followed by n deletes, recursive vs. iterative
+void benchmarkInsertDelete(const char* label, int keys[], int n) {
+    AVLNode* root = NULL;
+    clock_t t0 = clock();
+    for (int i = 0; i < n; i++) root = insert(root, keys[i]);
+    clock_t t1 = clock();
+    for (int i = 0; i < n; i++) root = deleteNode(root, keys[i]);
+    clock_t t2 = clock();
+    for (int i = 0; i < n; i++) root = insertIterative(root, keys[i]);
+    clock_t t3 = clock();
+    for (int i = 0; i < n; i++) root = deleteIterative(root, keys[i]);
+    clock_t t4 = clock();
+
+    double perOp = 1e9 / CLOCKS_PER_SEC / n;
+    printf("%-8s insert: recursive %6.1f ns, iterative %6.1f ns | "
+           "delete: recursive %6.1f ns, iterative %6.1f ns\n", label,
+           (t1 - t0) * perOp, (t3 - t2) * perOp, (t2 - t1) * perOp, (t4 - t3) * perOp);
+    freeTree(root);
+}
+
+// Compact node: the height is replaced by the balance factor
+// (height(left) - height(right), always -1/0/+1) in a one-byte field.
+// With an int key the byte fits in the padding after the key, so the
+// node is 24 bytes instead of 32 (32 instead of 48 on the heap, see
+// HEAP_BYTES below). Packing it into a child pointer's low bits would
+// save nothing more here, since alignment rounds the key up.
+typedef struct CompactAVLNode {
+    int key;
+    signed char balance;
+    struct CompactAVLNode* left;
+    struct CompactAVLNode* right;
+} CompactAVLNode;
+
+CompactAVLNode* createCompactNode(int key) {
+    CompactAVLNode* node = (CompactAVLNode*)malloc(sizeof(CompactAVLNode));
+    node->key = key;
+    node->balance = 0;
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
+
+// Right rotation: same pointer moves as rightRotate, but the balance
+// factors are derived from the old ones since heights are not stored
+CompactAVLNode* compactRightRotate(CompactAVLNode* y) {
+    CompactAVLNode* x = y->left;
+    CompactAVLNode* T2 = x->right;
+
+    // Perform rotation
+    x->right = y;
+    y->left = T2;
+
+    // Update balance factors
+    y->balance = y->balance - 1 - (x->balance > 0 ? x->balance : 0);
+    x->balance = x->balance - 1 + (y->balance < 0 ? y->balance : 0);
+
+    return x;
+}
+
+// Left rotation, mirror of compactRightRotate
+CompactAVLNode* compactLeftRotate(CompactAVLNode* x) {
+    CompactAVLNode* y = x->right;
+    CompactAVLNode* T2 = y->left;
+
+    // Perform rotation
+    y->left = x;
+    x->right = T2;
+
+    // Update balance factors
+    x->balance = x->balance + 1 - (y->balance < 0 ? y->balance : 0);
+    y->balance = y->balance + 1 + (x->balance > 0 ? x->balance : 0);
+
+    return y;
+}
+
+// Rebalance the node in *link, whose balance factor reached +2/-2, and
+// point *link (the parent's child pointer or the root) at the new top
+static void compactRebalance(CompactAVLNode** link) {
+    CompactAVLNode* node = *link;
+    if (node->balance > 1) {
+        if (node->left->balance < 0) // Left Right Case
+            node->left = compactLeftRotate(node->left);
+        *link = compactRightRotate(node);
+    } else {
+        if (node->right->balance > 0) // Right Left Case
+            node->right = compactRightRotate(node->right);
+        *link = compactLeftRotate(node);
+    }
+}
+
+CompactAVLNode* compactSearch(CompactAVLNode* root, int key) {
+    while (root != NULL && root->key != key)
+        root = (key < root->key) ? root->left : root->right;
+    return root;
+}
+
+// Insert using balance factors only. links[i] is the pointer that holds
+// the i-th node on the path (&root for the root), and dirs[i] is -1/+1
+// for the step taken out of it.
+CompactAVLNode* compactInsert(CompactAVLNode* root, int key) {
+    CompactAVLNode** links[MAX_HEIGHT];
+    int dirs[MAX_HEIGHT];
+    int depth = 0;
+
+    CompactAVLNode** link = &root;
+    while (*link != NULL) {
+        CompactAVLNode* current = *link;
+        if (key == current->key) // Duplicate keys not allowed
+            return root;
+        links[depth] = link;
+        dirs[depth] = (key < current->key) ? -1 : 1;
+        link = (dirs[depth] < 0) ? &current->left : &current->right;
+        depth++;
+    }
+    *link = createCompactNode(key);
+
+    // Retrace: the subtree under *links[i] grew on side dirs[i]
+    for (int i = depth - 1; i >= 0; i--) {
+        CompactAVLNode* n = *links[i];
+        n->balance -= dirs[i];
+        if (n->balance == 0)
+            break; // Height unchanged
+        if (n->balance == 2 || n->balance == -2) {
+            compactRebalance(links[i]);
+            break; // Rotation restores the pre-insert height
+        }
+    }
+    return root;
+}
+
+CompactAVLNode* compactDelete(CompactAVLNode* root, int key) {
+    CompactAVLNode** links[MAX_HEIGHT];
+    int dirs[MAX_HEIGHT];
+    int depth = 0;
+
+    CompactAVLNode** link = &root;
+    while (*link != NULL && (*link)->key != key) {
+        links[depth] = link;
+        dirs[depth] = (key < (*link)->key) ? -1 : 1;
+        link = (dirs[depth] < 0) ? &(*link)->left : &(*link)->right;
+        depth++;
+    }
+    CompactAVLNode* target = *link;
+    if (target == NULL) return root;
+
+    // Node with two children: remove the inorder successor instead
+    if (target->left != NULL && target->right != NULL) {
+        links[depth] = link;
+        dirs[depth++] = 1;
+        link = &target->right;
+        while ((*link)->left != NULL) {
+            links[depth] = link;
+            dirs[depth++] = -1;
+            link = &(*link)->left;
+        }
+        target->key = (*link)->key;
+        target = *link;
+    }
+
+    *link = (target->left != NULL) ? target->left : target->right;
+    free(target);
+
+    // Retrace: the subtree under *links[i] shrank on side dirs[i]
+    for (int i = depth - 1; i >= 0; i--) {
+        CompactAVLNode* n = *links[i];
+        n->balance += dirs[i];
+        if (n->balance == 2 || n->balance == -2) {
+            compactRebalance(links[i]);
+            n = *links[i];
+        }
+        if (n->balance != 0)
+            break; // Height unchanged
+    }
+    return root;
+}
+
+void freeCompactTree(CompactAVLNode* root) {
+    if (root != NULL) {
+        freeCompactTree(root->left);
+        freeCompactTree(root->right);
+        free(root);
+    }
+}
+
+// Iterative lookup in the height-node tree, to compare like with like
+AVLNode* searchIterative(AVLNode* root, int key) {
+    while (root != NULL && root->key != key)
+        root = (key < root->key) ? root->left : root->right;
+    return root;
+}
+
+// Per-allocation overhead of a typical malloc: an 8-byte chunk header,
+// with chunks rounded up to 16 bytes (glibc; other allocators are close).
+// HEAP_BYTES estimates what one malloc'd node really occupies.
+#define MALLOC_HEADER 8
+#define MALLOC_ALIGN 16
+#define HEAP_BYTES(size) (((size) + MALLOC_HEADER + MALLOC_ALIGN - 1) / MALLOC_ALIGN * MALLOC_ALIGN)
+
+// Compare memory and lookup speed of the two node layouts. Memory per
+// key is sizeof plus the allocator overhead above: 48 and 32 bytes.
+void benchmarkLayouts(int keys[], int n) {
+    AVLNode* root = NULL;
+    CompactAVLNode* compact = NULL;
+    for (int i = 0; i < n; i++) {
+        root = insertIterative(root, keys[i]);
+        compact = compactInsert(compact, keys[i]);
+    }
+
+    long found = 0;
+    clock_t t0 = clock();
+    for (int i = 0; i < n; i++) found += searchIterative(root, keys[(i * 7919L) % n]) != NULL;
+    clock_t t1 = clock();
+    for (int i = 0; i < n; i++) found += compactSearch(compact, keys[(i * 7919L) % n]) != NULL;
+    clock_t t2 = clock();
+
+    double perOp = 1e9 / CLOCKS_PER_SEC / n;
+    printf("height node:  sizeof %zu, ~%zu heap bytes/key, lookup %6.1f ns\n",
+           sizeof(AVLNode), (size_t)HEAP_BYTES(sizeof(AVLNode)), (t1 - t0) * perOp);
+    printf("balance node: sizeof %zu, ~%zu heap bytes/key, lookup %6.1f ns (found %ld)\n",
+           sizeof(CompactAVLNode), (size_t)HEAP_BYTES(sizeof(CompactAVLNode)), (t2 - t1) * perOp, found);
+    freeTree(root);
+    freeCompactTree(compact);
+}
+
+// Read-only snapshot of a tree in one contiguous array, in van Emde Boas
+// order: the top half of the tree (by height) is laid out first, then each
+// bottom subtree, each part recursively the same way. Any root-to-leaf walk
+// then touches O(log_B n) cache lines for every block size B at once.
+// Children are array indices (-1 for none), so a node is 12 bytes.
+typedef struct {
+    int key;
+    int left;
+    int right;
+} FrozenNode;
+
+typedef struct {
+    FrozenNode* nodes;
+    int n;
+} FrozenAVL;
+
+// Pass 1: copy the tree into a preorder array with index links
+static int copyPreorder(AVLNode* node, FrozenNode* tmp, int* count) {
+    if (node == NULL) return -1;
+    int i = (*count)++;
+    tmp[i].key = node->key;
+    tmp[i].left = copyPreorder(node->left, tmp, count);
+    tmp[i].right = copyPreorder(node->right, tmp, count);
+    return i;
+}
+
+static void vebLayout(FrozenNode* tmp, int i, int h, int* newIndex, int* pos);
+
+// Lay out every subtree rooted exactly depth levels below i
+static void vebLayoutBottoms(FrozenNode* tmp, int i, int depth, int h, int* newIndex, int* pos) {
+    if (i < 0) return;
+    if (depth == 0) {
+        vebLayout(tmp, i, h, newIndex, pos);
+        return;
+    }
+    vebLayoutBottoms(tmp, tmp[i].left, depth - 1, h, newIndex, pos);
+    vebLayoutBottoms(tmp, tmp[i].right, depth - 1, h, newIndex, pos);
+}
+
+// Pass 2: assign vEB positions to the subtree at i, cut off at height h
+static void vebLayout(FrozenNode* tmp, int i, int h, int* newIndex, int* pos) {
+    if (i < 0) return;
+    if (h == 1) {
+        newIndex[i] = (*pos)++;
+        return;
+    }
+    int topHeight = h / 2;
+    vebLayout(tmp, i, topHeight, newIndex, pos);
+    vebLayoutBottoms(tmp, i, topHeight, h - topHeight, newIndex, pos);
+}
+
+// Copy a tree into a vEB-ordered array. The tree itself is not modified.
+FrozenAVL avl_freeze(AVLNode* root) {
+    FrozenAVL frozen = {NULL, 0};
+    if (root == NULL) return frozen;
+
+    int n = 0;
+    FrozenNode* tmp = NULL;
+    int* newIndex = NULL;
+    // Count nodes first so every array is allocated once
+    AVLNode* stack[MAX_HEIGHT];
+    int top = 0;
+    stack[top++] = root;
+    while (top > 0) {
+        AVLNode* node = stack[--top];
+        n++;
+        if (node->left) stack[top++] = node->left;
+        if (node->right) stack[top++] = node->right;
+    }
+
+    tmp = (FrozenNode*)malloc(sizeof(FrozenNode) * n);
+    newIndex = (int*)malloc(sizeof(int) * n);
+    frozen.nodes = (FrozenNode*)malloc(sizeof(FrozenNode) * n);
+    if (tmp == NULL || newIndex == NULL || frozen.nodes == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    frozen.n = n;
+
+    int count = 0;
+    copyPreorder(root, tmp, &count);
+    int pos = 0;
+    vebLayout(tmp, 0, root->height, newIndex, &pos);
+
+    // Pass 3: move each node to its position and remap the child links
+    for (int i = 0; i < n; i++) {
+        FrozenNode* dst = &frozen.nodes[newIndex[i]];
+        dst->key = tmp[i].key;
+        dst->left = tmp[i].left < 0 ? -1 : newIndex[tmp[i].left];
+        dst->right = tmp[i].right < 0 ? -1 : newIndex[tmp[i].right];
+    }
+
+    free(tmp);
+    free(newIndex);
+    return frozen;
+}
+
+// Returns the index of key in the snapshot, or -1 if it is absent
+int avl_frozen_search(const FrozenAVL* frozen, int key) {
+    int i = frozen->n > 0 ? 0 : -1;
+    while (i >= 0) {
+        const FrozenNode* node = &frozen->nodes[i];
+        if (key == node->key) return i;
+        i = (key < node->key) ? node->left : node->right;
+    }
+    return -1;
+}
+
+void freeFrozen(FrozenAVL* frozen) {
+    free(frozen->nodes);
+    frozen->nodes = NULL;
+    frozen->n = 0;
+}
+
+// Heap footprint of one AVLNode, allocator overhead included
+#define AVL_HEAP_NODE HEAP_BYTES(sizeof(AVLNode))
+
+// Peak bytes per node while the sweep holds a tree and freezes it: the
+// node, the shuffled keys, and avl_freeze's preorder copy, index map and
+// result
+#define SWEEP_BYTES_PER_NODE (AVL_HEAP_NODE + sizeof(int) + 2 * sizeof(FrozenNode) + sizeof(int))
+
+// Lookup time of the pointer tree vs. its vEB snapshot, for trees
+// growing from L1-resident to 10x the last-level cache, or as far as
+// half of physical memory allows
+void benchmarkFreeze() {
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc <= 0) llc = 8L << 20; // Unknown: assume 8 MB
+    long long budget = (long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / 2;
+    long long maxNodes = budget / SWEEP_BYTES_PER_NODE;
+    if (maxNodes > (1 << 30)) maxNodes = 1 << 30; // Keys 2 * i must fit in an int
+    long long target = 10LL * llc / AVL_HEAP_NODE;
+    int lookups = 1000000;
+    int* probes = (int*)malloc(sizeof(int) * lookups);
+
+    // Stop at the first size past 10x LLC, or the last that fits
+    long lastN = 1024;
+    while (lastN < target && lastN * 4 <= maxNodes) lastN *= 4;
+    if (lastN < target) {
+        printf("LLC %ld KB; memory stops the sweep at %.1fx LLC (10x would need %lld MB)\n",
+               llc >> 10, (double)lastN * AVL_HEAP_NODE / llc,
+               target * (long long)SWEEP_BYTES_PER_NODE >> 20);
+    } else {
+        printf("LLC %ld KB, sweeping to %.1fx LLC\n", llc >> 10, (double)lastN * AVL_HEAP_NODE / llc);
+    }
+    printf("%10s %12s %12s %14s %14s %10s\n", "nodes", "tree bytes", "vEB bytes",
+           "pointer (ns)", "vEB (ns)", "hits");
+    for (long n = 1024; n <= lastN; n *= 4) {
+        // Even keys in random order, so probes of odd keys miss
+        int* keys = (int*)malloc(sizeof(int) * n);
+        for (long i = 0; i < n; i++) keys[i] = (int)(2 * i);
+        for (long i = n - 1; i > 0; i--) {
+            long j = ((long)rand() * RAND_MAX + rand()) % (i + 1);
+            int t = keys[i]; keys[i] = keys[j]; keys[j] = t;
+        }
+        AVLNode* root = NULL;
+        for (long i = 0; i < n; i++) root = insertIterative(root, keys[i]);
+        long treeBytes = n * (long)AVL_HEAP_NODE;
+        FrozenAVL frozen = avl_freeze(root);
+        for (int i = 0; i < lookups; i++) probes[i] = (int)(((long)rand() * RAND_MAX + rand()) % (2 * n));
+
+        long hits = 0;
+        clock_t t0 = clock();
+        for (int i = 0; i < lookups; i++) hits += search(root, probes[i]) != NULL;
+        clock_t t1 = clock();
+        for (int i = 0; i < lookups; i++) hits += avl_frozen_search(&frozen, probes[i]) >= 0;
+        clock_t t2 = clock();
+
+        double perOp = 1e9 / CLOCKS_PER_SEC / lookups;
+        printf("%10ld %12ld %12ld %14.1f %14.1f %10ld\n", n, treeBytes,
+               (long)frozen.n * (long)sizeof(FrozenNode), (t1 - t0) * perOp, (t2 - t1) * perOp, hits);
+        freeFrozen(&frozen);
+        freeTree(root);
+        free(keys);
+    }
+    free(probes);
+}
+
+// Binary image: "AVL1", a uint64 key count, then the keys as int32 in
+// sorted order (native byte order). Sorted keys are all that is needed:
+// avl_load rebuilds a perfectly balanced tree from them in O(n).
+static const char AVL_MAGIC[4] = {'A', 'V', 'L', '1'};
+#define IO_CHUNK 4096
+
+static int writeAll(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w <= 0) return -1;
+        p += w;
+        len -= (size_t)w;
+    }
+    return 0;
+}
+
+static int readAll(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t r = read(fd, p, len);
+        if (r <= 0) return -1;
+        p += r;
+        len -= (size_t)r;
+    }
+    return 0;
+}
+
+static uint64_t countNodes(AVLNode* root) {
+    return root == NULL ? 0 : 1 + countNodes(root->left) + countNodes(root->right);
+}
+
+// Write the tree's keys to fd. Returns 0 on success, -1 on a write error.
+int avl_save(AVLNode* root, int fd) {
+    uint64_t n = countNodes(root);
+    if (writeAll(fd, AVL_MAGIC, sizeof(AVL_MAGIC)) < 0 || writeAll(fd, &n, sizeof(n)) < 0)
+        return -1;
+
+    // Iterative inorder walk, buffered into chunks
+    int32_t buf[IO_CHUNK];
+    int used = 0;
+    AVLNode* stack[MAX_HEIGHT];
+    int top = 0;
+    AVLNode* current = root;
+    while (current != NULL || top > 0) {
+        while (current != NULL) {
+            stack[top++] = current;
+            current = current->left;
+        }
+        current = stack[--top];
+        buf[used++] = current->key;
+        if (used == IO_CHUNK) {
+            if (writeAll(fd, buf, sizeof(buf)) < 0) return -1;
+            used = 0;
+        }
+        current = current->right;
+    }
+    return writeAll(fd, buf, used * sizeof(int32_t));
+}
+
+// Build a balanced tree from keys[lo..hi]; heights are exact, no rotations
+static AVLNode* buildBalanced(const int32_t keys[], long lo, long hi) {
+    if (lo > hi) return NULL;
+    long mid = lo + (hi - lo) / 2;
+    AVLNode* node = createNode(keys[mid]);
+    node->left = buildBalanced(keys, lo, mid - 1);
+    node->right = buildBalanced(keys, mid + 1, hi);
+    updateHeight(node);
+    return node;
+}
+
+// Read an image written by avl_save. Returns NULL for an empty tree or on
+// error (bad header, bad key count, short read, keys out of order or out
+// of memory), reporting errors on stderr. The image is not trusted: a
+// corrupt one never yields a tree that breaks the BST ordering.
+AVLNode* avl_load(int fd) {
+    char magic[sizeof(AVL_MAGIC)];
+    uint64_t n;
+    if (readAll(fd, magic, sizeof(magic)) < 0 || memcmp(magic, AVL_MAGIC, sizeof(magic)) != 0
+        || readAll(fd, &n, sizeof(n)) < 0) {
+        fprintf(stderr, "avl_load: not an AVL image\n");
+        return NULL;
+    }
+    if (n == 0) return NULL;
+
+    // Reject counts that cannot be right before sizing a buffer from them
+    struct stat info;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (n > INT_MAX || (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && offset >= 0
+                        && n > (uint64_t)(info.st_size - offset) / sizeof(int32_t))) {
+        fprintf(stderr, "avl_load: bad key count %llu\n", (unsigned long long)n);
+        return NULL;
+    }
+
+    int32_t* keys = (int32_t*)malloc(sizeof(int32_t) * n);
+    if (keys == NULL) {
+        fprintf(stderr, "avl_load: out of memory for %llu keys\n", (unsigned long long)n);
+        return NULL;
+    }
+    if (readAll(fd, keys, sizeof(int32_t) * n) < 0) {
+        fprintf(stderr, "avl_load: truncated image\n");
+        free(keys);
+        return NULL;
+    }
+    for (uint64_t i = 1; i < n; i++) {
+        if (keys[i - 1] >= keys[i]) {
+            fprintf(stderr, "avl_load: keys not strictly increasing\n");
+            free(keys);
+            return NULL;
+        }
+    }
+    AVLNode* root = buildBalanced(keys, 0, (long)n - 1);
+    free(keys);
+    return root;
+}
+
+// Warm-up cost: re-inserting every key vs. loading a saved image
+void benchmarkSaveLoad(int keys[], int n) {
+    AVLNode* root = NULL;
+    clock_t t0 = clock();
+    for (int i = 0; i < n; i++) root = insertIterative(root, keys[i]);
+    clock_t t1 = clock();
+
+    FILE* f = tmpfile();
+    if (f == NULL) {
+        perror("tmpfile");
+        freeTree(root);
+        return;
+    }
+    int fd = fileno(f);
+    avl_save(root, fd);
+    clock_t t2 = clock();
+    lseek(fd, 0, SEEK_SET);
+    AVLNode* loaded = avl_load(fd);
+    clock_t t3 = clock();
+
+    double ms = 1000.0 / CLOCKS_PER_SEC;
+    printf("%d keys: re-insert %.1f ms, save %.1f ms, load %.1f ms (height %d vs %d)\n", n,
+           (t1 - t0) * ms, (t2 - t1) * ms, (t3 - t2) * ms, height(root), height(loaded));
+    fclose(f);
+    freeTree(root);
+    freeTree(loaded);
+}
+
 // Inorder traversal
 void inorder(AVLNode* root) {
     if (root != NULL) {
@@ -268,6 +954,51 @@ int main() {
     printf("Inorder traversal after deletion: ");
     inorder(root);
     printf("\n");
+    freeTree(root);
+
+    // Iterative versions build the same tree without recursion
+    root = NULL;
+    int keys[] = {10, 20, 30, 40, 50, 25};
+    for (int i = 0; i < 6; i++)
+        root = insertIterative(root, keys[i]);
+    root = deleteIterative(root, 30);
+    root = deleteIterative(root, 25);
+    printf("\nIterative insert/delete, preorder: ");
+    preorder(root);
+    printf("\n");
+    freeTree(root);
+
+    // Benchmark: random and sorted keys
+    int n = 1000000;
+    int* bench = (int*)malloc(sizeof(int) * n);
+    srand(42);
+    for (int i = 0; i < n; i++) bench[i] = rand();
+    printf("\n");
+    benchmarkInsertDelete("random", bench, n);
+    for (int i = 0; i < n; i++) bench[i] = i;
+    benchmarkInsertDelete("sorted", bench, n);
+    for (int i = 0; i < n; i++) bench[i] = rand();
+    printf("\n");
+    benchmarkLayouts(bench, n);
+    benchmarkSaveLoad(bench, n);
+    free(bench);
+
+    // Frozen snapshot: same answers, contiguous vEB layout
+    root = NULL;
+    for (int i = 0; i < 6; i++)
+        root = insert(root, keys[i]);
+    FrozenAVL frozen = avl_freeze(root);
+    printf("\nFrozen snapshot (%d nodes), vEB order: ", frozen.n);
+    for (int i = 0; i < frozen.n; i++)
+        printf("%d ", frozen.nodes[i].key);
+    printf("\nFrozen search 25: %s, 35: %s\n",
+           avl_frozen_search(&frozen, 25) >= 0 ? "found" : "not found",
+           avl_frozen_search(&frozen, 35) >= 0 ? "found" : "not found");
+    freeFrozen(&frozen);
+    freeTree(root);
+
+    printf("\n");
+    benchmarkFreeze();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+// AVL tree keyed by int with a long long value per key. Every node also
+// caches aggregates of its whole subtree (count, sum, min, max of the
+// values), kept up to date by the rotations, insert and deleteNode, so
+// range and order-statistic queries run in O(log n) instead of a traversal.
+
+typedef struct {
+    int count;
+    long long sum;
+    long long min;
+    long long max;
+} Aggregate;
+
+typedef struct AVLNode {
+    int key;
+    long long value;
+    struct AVLNode* left;
+    struct AVLNode* right;
+    int height;
+    Aggregate agg;      // Aggregate of this node's subtree
+} AVLNode;
+
+static const Aggregate EMPTY = {0, 0, LLONG_MAX, LLONG_MIN};
+
+// Combine two aggregates
+Aggregate combine(Aggregate a, Aggregate b) {
+    Aggregate r;
+    r.count = a.count + b.count;
+    r.sum = a.sum + b.sum;
+    r.min = a.min < b.min ? a.min : b.min;
+    r.max = a.max > b.max ? a.max : b.max;
+    return r;
+}
+
+// Aggregate of a single node's own value
+Aggregate single(AVLNode* node) {
+    Aggregate r = {1, node->value, node->value, node->value};
+    return r;
+}
+
+// Create a new node
+AVLNode* createNode(int key, long long value) {
+    AVLNode* node = (AVLNode*)malloc(sizeof(AVLNode));
+    node->key = key;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+    node->agg = single(node);
+    return node;
+}
+
+// Get height of node
+int height(AVLNode* node) {
+    if (node == NULL) return 0;
+    return node->height;
+}
+
+// Get subtree aggregate of node
+Aggregate aggregate(AVLNode* node) {
+    if (node == NULL) return EMPTY;
+    return node->agg;
+}
+
+// Get balance factor
+int getBalance(AVLNode* node) {
+    if (node == NULL) return 0;
+    return height(node->left) - height(node->right);
+}
+
+// Update height and subtree aggregate of node from its children
+void updateNode(AVLNode* node) {
+    if (node != NULL) {
+        int leftHeight = height(node->left);
+        int rightHeight = height(node->right);
+        node->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+        node->agg = combine(combine(aggregate(node->left), single(node)), aggregate(node->right));
+    }
+}
+
+// Right rotation
+AVLNode* rightRotate(AVLNode* y) {
+    AVLNode* x = y->left;
+    AVLNode* T2 = x->right;
+
+    // Perform rotation
+    x->right = y;
+    y->left = T2;
+
+    // Update heights and aggregates, lower node first
+    updateNode(y);
+    updateNode(x);
+
+    return x;
+}
+
+// Left rotation
+AVLNode* leftRotate(AVLNode* x) {
+    AVLNode* y = x->right;
+    AVLNode* T2 = y->left;
+
+    // Perform rotation
+    y->left = x;
+    x->right = T2;
+
+    // Update heights and aggregates, lower node first
+    updateNode(x);
+    updateNode(y);
+
+    return y;
+}
+
+// Find node with minimum key
+AVLNode* minValueNode(AVLNode* node) {
+    AVLNode* current = node;
+    while (current && current->left != NULL)
+        current = current->left;
+    return current;
+}
+
+// Search for a key
+AVLNode* search(AVLNode* root, int key) {
+    while (root != NULL && root->key != key)
+        root = (key < root->key) ? root->left : root->right;
+    return root;
+}
+
+// Restore balance at node after one of its subtrees changed height
+AVLNode* rebalance(AVLNode* node) {
+    updateNode(node);
+    int balance = getBalance(node);
+
+    // Left Left / Left Right Case
+    if (balance > 1) {
+        if (getBalance(node->left) < 0)
+            node->left = leftRotate(node->left);
+        return rightRotate(node);
+    }
+
+    // Right Right / Right Left Case
+    if (balance < -1) {
+        if (getBalance(node->right) > 0)
+            node->right = rightRotate(node->right);
+        return leftRotate(node);
+    }
+
+    return node;
+}
+
+// Insert key -> value (overwrites the value of an existing key)
+AVLNode* insert(AVLNode* node, int key, long long value) {
+    if (node == NULL) return createNode(key, value);
+
+    if (key < node->key)
+        node->left = insert(node->left, key, value);
+    else if (key > node->key)
+        node->right = insert(node->right, key, value);
+    else
+        node->value = value; // Aggregates above still change, so fall through
+
+    return rebalance(node);
+}
+
+// Delete node and balance the tree
+AVLNode* deleteNode(AVLNode* root, int key) {
+    if (root == NULL) return root;
+
+    if (key < root->key)
+        root->left = deleteNode(root->left, key);
+    else if (key > root->key)
+        root->right = deleteNode(root->right, key);
+    else {
+        // Node with only one child or no child
+        if (root->left == NULL || root->right == NULL) {
+            AVLNode* temp = root->left ? root->left : root->right;
+            free(root);
+            return temp;
+        }
+
+        // Node with two children: take over the inorder successor's entry
+        AVLNode* temp = minValueNode(root->right);
+        root->key = temp->key;
+        root->value = temp->value;
+        root->right = deleteNode(root->right, temp->key);
+    }
+
+    return rebalance(root);
+}
+
+// Aggregate of values for keys in [a, b]. Below the node where a and b
+// split, each step either adds a whole child subtree or discards one,
+// so this is two root-to-leaf walks.
+Aggregate avl_range(AVLNode* root, int a, int b) {
+    Aggregate acc = EMPTY;
+    if (a > b) return acc;
+
+    // Find the split node
+    while (root != NULL && (root->key < a || root->key > b))
+        root = (root->key < a) ? root->right : root->left;
+    if (root == NULL) return acc;
+
+    acc = single(root);
+
+    // Keys >= a in the left subtree
+    for (AVLNode* n = root->left; n != NULL; ) {
+        if (n->key >= a) {
+            acc = combine(acc, combine(single(n), aggregate(n->right)));
+            n = n->left;
+        } else {
+            n = n->right;
+        }
+    }
+
+    // Keys <= b in the right subtree
+    for (AVLNode* n = root->right; n != NULL; ) {
+        if (n->key <= b) {
+            acc = combine(acc, combine(single(n), aggregate(n->left)));
+            n = n->right;
+        } else {
+            n = n->left;
+        }
+    }
+    return acc;
+}
+
+// Sum of values for keys in [a, b]
+long long avl_range_sum(AVLNode* root, int a, int b) {
+    return avl_range(root, a, b).sum;
+}
+
+// Number of keys strictly less than key
+int avl_rank(AVLNode* root, int key) {
+    int rank = 0;
+    while (root != NULL) {
+        if (key <= root->key) {
+            root = root->left;
+        } else {
+            rank += aggregate(root->left).count + 1;
+            root = root->right;
+        }
+    }
+    return rank;
+}
+
+// Node holding the k-th smallest key (0-based), or NULL if k is out of range
+AVLNode* avl_select(AVLNode* root, int k) {
+    while (root != NULL) {
+        int leftCount = aggregate(root->left).count;
+        if (k < leftCount) {
+            root = root->left;
+        } else if (k == leftCount) {
+            return root;
+        } else {
+            k -= leftCount + 1;
+            root = root->right;
+        }
+    }
+    return NULL;
+}
+
+// Inorder traversal
+void inorder(AVLNode* root) {
+    if (root != NULL) {
+        inorder(root->left);
+        printf("%d:%lld ", root->key, root->value);
+        inorder(root->right);
+    }
+}
+
+// Free every node
+void freeTree(AVLNode* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+// Example usage
+int main() {
+    AVLNode* root = NULL;
+
+    // Timestamp -> latency samples
+    int keys[] = {10, 20, 30, 40, 50, 25, 35, 5};
+    long long values[] = {7, 3, 9, 1, 4, 12, 6, 8};
+    for (int i = 0; i < 8; i++)
+        root = insert(root, keys[i], values[i]);
+
+    printf("Inorder (key:value): ");
+    inorder(root);
+    printf("\n");
+
+    Aggregate r = avl_range(root, 20, 40);
+    printf("Keys in [20, 40]: count %d, sum %lld, min %lld, max %lld\n", r.count, r.sum, r.min, r.max);
+    printf("avl_range_sum(0, 100) = %lld\n", avl_range_sum(root, 0, 100));
+    printf("avl_rank(30) = %d\n", avl_rank(root, 30));
+    printf("avl_select(3) = key %d\n", avl_select(root, 3)->key);
+
+    printf("\nDeleting 30, overwriting 25 -> 0\n");
+    root = deleteNode(root, 30);
+    root = insert(root, 25, 0);
+    r = avl_range(root, 20, 40);
+    printf("Keys in [20, 40]: count %d, sum %lld, min %lld, max %lld\n", r.count, r.sum, r.min, r.max);
+    printf("avl_rank(30) = %d, avl_select(3) = key %d\n", avl_rank(root, 30), avl_select(root, 3)->key);
+
+    freeTree(root);
+    return 0;
+}
@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Multiset variant of AVL_TREE.c: a key inserted twice is stored once
+// with count 2, so a tree of event keys doubles as the event counter.
+// avl_merge_sorted adds a whole sorted batch in one walk over the tree
+// (join-based union) instead of one root-to-leaf descent per key.
+
+typedef struct AVLNode {
+    int key;
+    int count;          // Number of times key is in the multiset
+    struct AVLNode* left;
+    struct AVLNode* right;
+    int height;
+} AVLNode;
+
+// Create a new node
+AVLNode* createNode(int key, int count) {
+    AVLNode* node = (AVLNode*)malloc(sizeof(AVLNode));
+    node->key = key;
+    node->count = count;
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+    return node;
+}
+
+// Get height of node
+int height(AVLNode* node) {
+    if (node == NULL) return 0;
+    return node->height;
+}
+
+// Get balance factor
+int getBalance(AVLNode* node) {
+    if (node == NULL) return 0;
+    return height(node->left) - height(node->right);
+}
+
+// Update height of node
+void updateHeight(AVLNode* node) {
+    if (node != NULL) {
+        int leftHeight = height(node->left);
+        int rightHeight = height(node->right);
+        node->height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+    }
+}
+
+// Right rotation
+AVLNode* rightRotate(AVLNode* y) {
+    AVLNode* x = y->left;
+    AVLNode* T2 = x->right;
+
+    // Perform rotation
+    x->right = y;
+    y->left = T2;
+
+    // Update heights
+    updateHeight(y);
+    updateHeight(x);
+
+    return x;
+}
+
+// Left rotation
+AVLNode* leftRotate(AVLNode* x) {
+    AVLNode* y = x->right;
+    AVLNode* T2 = y->left;
+
+    // Perform rotation
+    y->left = x;
+    x->right = T2;
+
+    // Update heights
+    updateHeight(x);
+    updateHeight(y);
+
+    return y;
+}
+
+// Restore balance at node after one of its subtrees changed height by one
+AVLNode* rebalance(AVLNode* node) {
+    updateHeight(node);
+    int balance = getBalance(node);
+
+    // Left Left / Left Right Case
+    if (balance > 1) {
+        if (getBalance(node->left) < 0)
+            node->left = leftRotate(node->left);
+        return rightRotate(node);
+    }
+
+    // Right Right / Right Left Case
+    if (balance < -1) {
+        if (getBalance(node->right) > 0)
+            node->right = rightRotate(node->right);
+        return leftRotate(node);
+    }
+
+    return node;
+}
+
+// Find node with minimum value
+AVLNode* minValueNode(AVLNode* node) {
+    AVLNode* current = node;
+    while (current && current->left != NULL)
+        current = current->left;
+    return current;
+}
+
+// Number of occurrences of key
+int getCount(AVLNode* root, int key) {
+    while (root != NULL && root->key != key)
+        root = (key < root->key) ? root->left : root->right;
+    return root == NULL ? 0 : root->count;
+}
+
+// Add one occurrence of key
+AVLNode* insert(AVLNode* node, int key) {
+    if (node == NULL) return createNode(key, 1);
+
+    if (key < node->key)
+        node->left = insert(node->left, key);
+    else if (key > node->key)
+        node->right = insert(node->right, key);
+    else {
+        node->count++; // Duplicate: shape unchanged
+        return node;
+    }
+
+    return rebalance(node);
+}
+
+// Remove one occurrence of key; the node goes when its count reaches 0
+AVLNode* deleteNode(AVLNode* root, int key) {
+    if (root == NULL) return root;
+
+    if (key < root->key)
+        root->left = deleteNode(root->left, key);
+    else if (key > root->key)
+        root->right = deleteNode(root->right, key);
+    else {
+        if (--root->count > 0)
+            return root;
+
+        // Node with only one child or no child
+        if (root->left == NULL || root->right == NULL) {
+            AVLNode* temp = root->left ? root->left : root->right;
+            free(root);
+            return temp;
+        }
+
+        // Node with two children: take over the inorder successor's entry
+        AVLNode* temp = minValueNode(root->right);
+        root->key = temp->key;
+        root->count = temp->count;
+        temp->count = 1; // So the recursive call removes the successor node outright
+        root->right = deleteNode(root->right, temp->key);
+    }
+
+    return rebalance(root);
+}
+
+// --- Join-based bulk merge ---
+
+// Join where left is taller: walk down left's right spine to a node of
+// about right's height, hang k there, and rebalance on the way back up
+static AVLNode* joinRight(AVLNode* left, AVLNode* k, AVLNode* right) {
+    AVLNode* l = left->left;
+    AVLNode* c = left->right;
+
+    if (height(c) <= height(right) + 1) {
+        k->left = c;
+        k->right = right;
+        updateHeight(k);
+        if (height(k) <= height(l) + 1) {
+            left->right = k;
+            updateHeight(left);
+            return left;
+        }
+        left->right = rightRotate(k);
+        updateHeight(left);
+        return leftRotate(left);
+    }
+
+    left->right = joinRight(c, k, right);
+    updateHeight(left);
+    if (height(left->right) <= height(l) + 1)
+        return left;
+    return leftRotate(left);
+}
+
+// Mirror of joinRight, for a taller right tree
+static AVLNode* joinLeft(AVLNode* left, AVLNode* k, AVLNode* right) {
+    AVLNode* r = right->right;
+    AVLNode* c = right->left;
+
+    if (height(c) <= height(left) + 1) {
+        k->left = left;
+        k->right = c;
+        updateHeight(k);
+        if (height(k) <= height(r) + 1) {
+            right->left = k;
+            updateHeight(right);
+            return right;
+        }
+        right->left = leftRotate(k);
+        updateHeight(right);
+        return rightRotate(right);
+    }
+
+    right->left = joinLeft(left, k, c);
+    updateHeight(right);
+    if (height(right->left) <= height(r) + 1)
+        return right;
+    return rightRotate(right);
+}
+
+// Balanced tree of (every key in left) < k->key < (every key in right),
+// for any height difference, in O(|height(left) - height(right)|)
+static AVLNode* join(AVLNode* left, AVLNode* k, AVLNode* right) {
+    if (height(left) > height(right) + 1)
+        return joinRight(left, k, right);
+    if (height(right) > height(left) + 1)
+        return joinLeft(left, k, right);
+    k->left = left;
+    k->right = right;
+    updateHeight(k);
+    return k;
+}
+
+// First index in keys[lo, hi) whose key is >= key
+static int lowerBound(const int keys[], int lo, int hi, int key) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (keys[mid] < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Balanced tree over distinct keys[lo, hi) with their counts
+static AVLNode* buildBalanced(const int keys[], const int counts[], int lo, int hi) {
+    if (lo >= hi) return NULL;
+    int mid = lo + (hi - lo) / 2;
+    AVLNode* node = createNode(keys[mid], counts[mid]);
+    node->left = buildBalanced(keys, counts, lo, mid);
+    node->right = buildBalanced(keys, counts, mid + 1, hi);
+    updateHeight(node);
+    return node;
+}
+
+// Merge distinct sorted keys[lo, hi) into the subtree. The batch is split
+// at each node's key, so the tree is walked once for the whole batch and
+// subtrees no batch key falls into are never visited.
+static AVLNode* mergeRange(AVLNode* node, const int keys[], const int counts[], int lo, int hi) {
+    if (lo >= hi) return node;
+    if (node == NULL) return buildBalanced(keys, counts, lo, hi);
+
+    int split = lowerBound(keys, lo, hi, node->key);
+    int after = split;
+    if (after < hi && keys[after] == node->key)
+        node->count += counts[after++];
+
+    AVLNode* left = mergeRange(node->left, keys, counts, lo, split);
+    AVLNode* right = mergeRange(node->right, keys, counts, after, hi);
+    return join(left, node, right);
+}
+
+// Add n keys, sorted ascending (duplicates allowed), in one pass
+AVLNode* avl_merge_sorted(AVLNode* root, const int keys[], int n) {
+    if (n <= 0) return root;
+
+    // Collapse runs of equal keys into (key, count) pairs
+    int* distinct = (int*)malloc(sizeof(int) * n);
+    int* counts = (int*)malloc(sizeof(int) * n);
+    if (distinct == NULL || counts == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (m > 0 && distinct[m - 1] == keys[i]) {
+            counts[m - 1]++;
+        } else {
+            distinct[m] = keys[i];
+            counts[m++] = 1;
+        }
+    }
+
+    root = mergeRange(root, distinct, counts, 0, m);
+    free(distinct);
+    free(counts);
+    return root;
+}
+
+// Inorder traversal
+void inorder(AVLNode* root) {
+    if (root != NULL) {
+        inorder(root->left);
+        printf("%dx%d ", root->key, root->count);
+        inorder(root->right);
+    }
+}
+
+// Free every node
+void freeTree(AVLNode* root) {
+    if (root != NULL) {
+        freeTree(root->left);
+        freeTree(root->right);
+        free(root);
+    }
+}
+
+static int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Merging sorted batches vs. inserting each event separately
+void benchmarkMerge(int treeSize, int batchSize, int batches) {
+    int* batch = (int*)malloc(sizeof(int) * batchSize);
+    AVLNode* a = NULL;
+    AVLNode* b = NULL;
+    for (int i = 0; i < treeSize; i++) {
+        int key = rand() % (4 * treeSize);
+        a = insert(a, key);
+        b = insert(b, key);
+    }
+
+    clock_t single = 0, merged = 0;
+    for (int t = 0; t < batches; t++) {
+        for (int i = 0; i < batchSize; i++) batch[i] = rand() % (4 * treeSize);
+        qsort(batch, batchSize, sizeof(int), compareInts);
+
+        clock_t t0 = clock();
+        for (int i = 0; i < batchSize; i++) a = insert(a, batch[i]);
+        clock_t t1 = clock();
+        b = avl_merge_sorted(b, batch, batchSize);
+        clock_t t2 = clock();
+        single += t1 - t0;
+        merged += t2 - t1;
+    }
+
+    double perKey = 1e9 / CLOCKS_PER_SEC / ((double)batchSize * batches);
+    printf("tree %8d, batch %7d: insert each %6.1f ns/key, merge %6.1f ns/key\n",
+           treeSize, batchSize, single * perKey, merged * perKey);
+    freeTree(a);
+    freeTree(b);
+    free(batch);
+}
+
+// Example usage
+int main() {
+    AVLNode* root = NULL;
+
+    printf("Inserting events: 10, 20, 10, 30, 10, 20\n");
+    int events[] = {10, 20, 10, 30, 10, 20};
+    for (int i = 0; i < 6; i++)
+        root = insert(root, events[i]);
+    printf("Inorder (key x count): ");
+    inorder(root);
+    printf("\n");
+
+    int batch[] = {5, 10, 10, 25, 30, 40, 40, 40};
+    root = avl_merge_sorted(root, batch, 8);
+    printf("After merging {5, 10, 10, 25, 30, 40, 40, 40}: ");
+    inorder(root);
+    printf("\nCount of 10: %d, count of 40: %d, height %d\n",
+           getCount(root, 10), getCount(root, 40), height(root));
+
+    root = deleteNode(root, 10);
+    root = deleteNode(root, 30);
+    root = deleteNode(root, 30);
+    printf("After removing 10 once and 30 twice: ");
+    inorder(root);
+    printf("\n\n");
+    freeTree(root);
+
+    srand(42);
+    benchmarkMerge(1000000, 100, 100);
+    benchmarkMerge(1000000, 10000, 10);
+    benchmarkMerge(1000000, 1000000, 1);
+
+    return 0;
+}
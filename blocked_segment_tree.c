@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Benchmarked against segment_tree.c (include idiom: see its main)
+#define main segmentTreeDemo
+#include "segment_tree.c"
+#undef main
+
+// Segment tree with blocked leaves: the array is cut into blocks of B
+// elements (16-64, a cache line or a few), and the tree is built over
+// the block sums only, using the iterative 2n layout. A query sums its
+// two partial end blocks directly with a vector kernel and asks the tree
+// for the whole blocks in between, so the bottom log2(B) levels of
+// recursion become one or two streaming loads, and the tree is B times
+// smaller than segment_tree.c's 4n nodes.
+//
+// The kernel is picked at compile time: AVX-512 or AVX2 when the compiler
+// targets them (e.g. -O2 -march=native), a scalar loop otherwise.
+
+typedef struct {
+    int* data;       // The elements, 64-byte aligned, padded with zeros to whole blocks
+    int* tree;       // Block sums: leaves at [numBlocks, 2 * numBlocks)
+    int n;           // Size of the original input array
+    int numBlocks;
+    int blockShift;  // Block size is 1 << blockShift
+} BlockedSegmentTree;
+
+/**
+ * @brief Sum of p[0, len) with the widest vector kernel available.
+ */
+static inline int sumBlock(const int* p, int len) {
+#if defined(__AVX512F__)
+    __m512i acc = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        acc = _mm512_add_epi32(acc, _mm512_loadu_si512((const void*)(p + i)));
+    }
+    if (i < len) {
+        // Masked load of the tail: lanes past len read as zero
+        __mmask16 mask = (__mmask16)((1u << (len - i)) - 1);
+        acc = _mm512_add_epi32(acc, _mm512_maskz_loadu_epi32(mask, p + i));
+    }
+    return _mm512_reduce_add_epi32(acc);
+#elif defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= len; i += 8) {
+        acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i*)(p + i)));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    int sum = _mm_cvtsi128_si32(half);
+    for (; i < len; i++) {
+        sum += p[i];
+    }
+    return sum;
+#else
+    int sum = 0;
+    for (int i = 0; i < len; i++) {
+        sum += p[i];
+    }
+    return sum;
+#endif
+}
+
+static const char* kernelName() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * @brief Builds the blocked tree in O(n).
+ * @param arr The input array
+ * @param n Size of the input array
+ * @param blockShift log2 of the block size (4..6 for 16..64 elements)
+ * @return A new, initialized BlockedSegmentTree
+ */
+BlockedSegmentTree createBlockedSegmentTree(int arr[], int n, int blockShift) {
+    BlockedSegmentTree st;
+    int block = 1 << blockShift;
+    st.n = n;
+    st.blockShift = blockShift;
+    st.numBlocks = (n + block - 1) >> blockShift;
+
+    size_t dataBytes = sizeof(int) * (size_t)st.numBlocks * block;
+    st.data = (int*)aligned_alloc(64, (dataBytes + 63) / 64 * 64);
+    st.tree = (int*)malloc(sizeof(int) * 2 * st.numBlocks);
+    if (st.data == NULL || st.tree == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    memcpy(st.data, arr, sizeof(int) * n);
+    memset(st.data + n, 0, dataBytes - sizeof(int) * n);
+
+    for (int b = 0; b < st.numBlocks; b++) {
+        st.tree[st.numBlocks + b] = sumBlock(st.data + ((size_t)b << blockShift), block);
+    }
+    for (int i = st.numBlocks - 1; i > 0; i--) {
+        st.tree[i] = st.tree[2 * i] + st.tree[2 * i + 1];
+    }
+    return st;
+}
+
+/**
+ * @brief Range sum over [L, R]: partial end blocks through the kernel,
+ *        whole blocks in between through the tree.
+ */
+int blockedQuery(BlockedSegmentTree* st, int L, int R) {
+    if (L < 0 || R > st->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    int bL = L >> st->blockShift;
+    int bR = R >> st->blockShift;
+    if (bL == bR) {
+        return sumBlock(st->data + L, R - L + 1);
+    }
+
+    int blockEnd = (bL + 1) << st->blockShift;
+    int sum = sumBlock(st->data + L, blockEnd - L);
+    int blockStart = bR << st->blockShift;
+    sum += sumBlock(st->data + blockStart, R - blockStart + 1);
+
+    // Whole blocks bL + 1 .. bR - 1
+    for (int l = bL + 1 + st->numBlocks, r = bR + st->numBlocks; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) sum += st->tree[l++];
+        if (r & 1) sum += st->tree[--r];
+    }
+    return sum;
+}
+
+/**
+ * @brief Sets element idx to newValue. The block sum changes by the
+ *        difference, so the block itself is never re-summed.
+ */
+void blockedUpdate(BlockedSegmentTree* st, int idx, int newValue) {
+    if (idx < 0 || idx > st->n - 1) {
+        fprintf(stderr, "Invalid update index\n");
+        return;
+    }
+    int delta = newValue - st->data[idx];
+    st->data[idx] = newValue;
+    for (int i = (idx >> st->blockShift) + st->numBlocks; i > 0; i >>= 1) {
+        st->tree[i] += delta;
+    }
+}
+
+/**
+ * @brief Frees all allocated memory for the blocked tree.
+ */
+void freeBlockedSegmentTree(BlockedSegmentTree* st) {
+    free(st->data);
+    free(st->tree);
+    st->data = NULL;
+    st->tree = NULL;
+    st->n = st->numBlocks = 0;
+}
+
+/**
+ * @brief Query and update latency for block sizes 16, 32 and 64 against
+ *        the recursive and iterative trees of segment_tree.c.
+ * @param n Number of elements
+ * @param ops Number of queries (and of updates)
+ */
+void benchmarkBlocked(int n, int ops) {
+    int* arr = (int*)malloc(sizeof(int) * n);
+    int* Ls = (int*)malloc(sizeof(int) * ops);
+    int* Rs = (int*)malloc(sizeof(int) * ops);
+    for (int i = 0; i < n; i++) arr[i] = rand() % 10; // Keeps int sums in range
+    for (int i = 0; i < ops; i++) {
+        int a = rand() % n, b = rand() % n;
+        Ls[i] = a < b ? a : b;
+        Rs[i] = a < b ? b : a;
+    }
+
+    double ns = 1e9 / CLOCKS_PER_SEC;
+    long long reference = 0;
+    printf("n = %d\n", n);
+
+    SegmentTree rec = createSegmentTree(arr, n);
+    clock_t t0 = clock();
+    for (int i = 0; i < ops; i++) reference += query(&rec, Ls[i], Rs[i]);
+    clock_t t1 = clock();
+    for (int i = 0; i < ops; i++) update(&rec, Ls[i], Rs[i] % 10);
+    clock_t t2 = clock();
+    printf("  %-22s query %6.1f ns  update %6.1f ns  %6.1f MB\n", "recursive (4n)",
+           (t1 - t0) * ns / ops, (t2 - t1) * ns / ops,
+           (double)n * 4 * (sizeof(int) + sizeof(LazyTag)) / (1 << 20));
+    freeSegmentTree(&rec);
+
+    IterSegmentTree it = createIterSegmentTree(arr, n);
+    long long check = 0;
+    t0 = clock();
+    for (int i = 0; i < ops; i++) check += iterQuery(&it, Ls[i], Rs[i]);
+    t1 = clock();
+    for (int i = 0; i < ops; i++) iterUpdate(&it, Ls[i], Rs[i] % 10);
+    t2 = clock();
+    printf("  %-22s query %6.1f ns  update %6.1f ns  %6.1f MB%s\n", "iterative (2n)",
+           (t1 - t0) * ns / ops, (t2 - t1) * ns / ops, (double)n * 2 * sizeof(int) / (1 << 20),
+           check == reference ? "" : " (MISMATCH)");
+    freeIterSegmentTree(&it);
+
+    for (int shift = 4; shift <= 6; shift++) {
+        BlockedSegmentTree bt = createBlockedSegmentTree(arr, n, shift);
+        check = 0;
+        t0 = clock();
+        for (int i = 0; i < ops; i++) check += blockedQuery(&bt, Ls[i], Rs[i]);
+        t1 = clock();
+        for (int i = 0; i < ops; i++) blockedUpdate(&bt, Ls[i], Rs[i] % 10);
+        t2 = clock();
+        char label[32];
+        snprintf(label, sizeof(label), "blocked B=%d (%s)", 1 << shift, kernelName());
+        printf("  %-22s query %6.1f ns  update %6.1f ns  %6.1f MB%s\n", label,
+               (t1 - t0) * ns / ops, (t2 - t1) * ns / ops,
+               (double)(n + 2 * bt.numBlocks) * sizeof(int) / (1 << 20),
+               check == reference ? "" : " (MISMATCH)");
+        freeBlockedSegmentTree(&bt);
+    }
+
+    free(arr);
+    free(Ls);
+    free(Rs);
+}
+
+// --- Example Usage ---
+int main() {
+    int arr[40];
+    for (int i = 0; i < 40; i++) arr[i] = i + 1;
+
+    BlockedSegmentTree st = createBlockedSegmentTree(arr, 40, 4); // Blocks of 16
+    printf("Kernel: %s, %d blocks\n", kernelName(), st.numBlocks);
+    printf("Sum of range [3, 9] is: %d\n", blockedQuery(&st, 3, 9));     // 49, one block
+    printf("Sum of range [5, 37] is: %d\n", blockedQuery(&st, 5, 37));   // 726, three blocks
+    blockedUpdate(&st, 20, 0);
+    printf("After arr[20] = 0: sum [5, 37] = %d\n\n", blockedQuery(&st, 5, 37)); // 705
+    freeBlockedSegmentTree(&st);
+
+    srand(42);
+    benchmarkBlocked(100000, 1000000);
+    benchmarkBlocked(10000000, 1000000);
+    return 0;
+}
@@ -0,0 +1,747 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// -----------------------------------------------------------------
+// 1. Type Definitions and Structures
+// -----------------------------------------------------------------
+
+// A reader-writer concurrent red-black map.
+//
+// Writers serialize on a mutex and never modify a node that readers can
+// see: like persistent_red_black.c they copy the root-to-target path,
+// rebalance the private copies and then publish the new root with one
+// atomic store. Readers load the root and walk immutable nodes, so the
+// read path takes no lock and performs no atomic writes.
+//
+// Nodes replaced by a copy are retired, not freed. Reclamation is
+// epoch based (quiescent-state style): each reader periodically stores
+// the global epoch into its own padded slot to say "I hold no node
+// pointers right now", and a node retired in epoch E is freed once
+// every online reader has announced an epoch greater than E.
+
+// Color enumeration
+typedef enum { RED, BLACK } Color;
+
+// Node structure (immutable once published)
+typedef struct CNode {
+    int key;
+    int value;
+    Color color;
+    unsigned long stamp;    // Write sequence that created this node
+    struct CNode *left;
+    struct CNode *right;
+} CNode;
+
+#define MAX_DEPTH 128       // Red-black height bound, see persistent_red_black.c
+#define MAX_READERS 64
+#define CACHE_LINE 64
+#define EPOCH_OFFLINE UINT64_MAX
+
+// One reader's announced epoch, padded so readers never share a cache line
+typedef struct {
+    _Atomic uint64_t epoch;
+    char pad[CACHE_LINE - sizeof(uint64_t)];
+} ReaderSlot;
+
+// A node waiting for every reader to move past the epoch it was retired in
+typedef struct {
+    CNode* node;
+    uint64_t epoch;
+} Retired;
+
+// Concurrent map structure
+typedef struct RBMap {
+    _Atomic(CNode*) root;
+    _Atomic uint64_t epoch;          // Global epoch, bumped after each publish
+    ReaderSlot readers[MAX_READERS];
+    _Atomic int numReaders;
+
+    // Writer-only state, protected by writeLock
+    pthread_mutex_t writeLock;
+    unsigned long writeSeq;          // Nodes stamped with this are private to the current write
+    Retired* retired;
+    size_t numRetired;
+    size_t capRetired;
+} RBMap;
+
+// -----------------------------------------------------------------
+// 2. Function Prototypes
+// -----------------------------------------------------------------
+
+// --- Public Functions ---
+RBMap* createRBMap();
+int registerReader(RBMap* map);
+void readerQuiescent(RBMap* map, int id);
+void readerOffline(RBMap* map, int id);
+void readerOnline(RBMap* map, int id);
+CNode* search(RBMap* map, int key);
+void insert(RBMap* map, int key, int value);
+void deleteNode(RBMap* map, int key);
+void inorder(RBMap* map);
+void freeRBMap(RBMap* map);
+
+// --- Internal Helper Functions ---
+CNode* createNode(RBMap* map, int key, int value);
+CNode* own(RBMap* map, CNode** slot);
+void retireNode(RBMap* map, CNode* node);
+void reclaim(RBMap* map);
+void publish(RBMap* map, CNode* newRoot);
+CNode* leftRotate(CNode* x);
+CNode* rightRotate(CNode* y);
+void replaceChild(CNode** root, CNode* parent, CNode* oldChild, CNode* newChild);
+void insertFixup(RBMap* map, CNode** root, CNode* path[], int depth);
+void deleteFixup(RBMap* map, CNode** root, CNode* path[], int k, CNode* x, int xIsLeft);
+void inorderHelper(CNode* node);
+void freeTreeHelper(CNode* node);
+
+// --- Benchmark ---
+void benchmark(int useRwLock, int numReaders, double seconds);
+
+
+// -----------------------------------------------------------------
+// 3. Main Function (Driver Code)
+// -----------------------------------------------------------------
+
+int main() {
+    // 1. Single-threaded sanity run
+    RBMap* map = createRBMap();
+    int keys_to_insert[] = {10, 20, 30, 15, 25, 5, 1};
+    int num_keys = sizeof(keys_to_insert) / sizeof(keys_to_insert[0]);
+
+    printf("Inserting keys: ");
+    for (int i = 0; i < num_keys; i++) {
+        printf("%d ", keys_to_insert[i]);
+        insert(map, keys_to_insert[i], keys_to_insert[i] * 100);
+    }
+    printf("\n");
+    inorder(map);
+
+    deleteNode(map, 30);
+    deleteNode(map, 10);
+    printf("After deleting 30 and 10:\n");
+    inorder(map);
+
+    CNode* found = search(map, 15);
+    printf("Search 15: %s (value %d)\n", found ? "found" : "not found", found ? found->value : 0);
+    printf("Retired nodes pending (no readers registered): %zu\n", map->numRetired);
+    freeRBMap(map);
+
+    // 2. Reader scaling: one writer, N readers, epoch map vs. pthread_rwlock
+    printf("\n=====================================\n");
+    printf("%8s %22s %22s\n", "readers", "epoch map (Mops/s)", "rwlock (Mops/s)");
+    int reader_counts[] = {1, 2, 4, 8, 16, 32};
+    for (int i = 0; i < (int)(sizeof(reader_counts) / sizeof(reader_counts[0])); i++) {
+        printf("%8d ", reader_counts[i]);
+        benchmark(0, reader_counts[i], 0.25);
+        benchmark(1, reader_counts[i], 0.25);
+        printf("\n");
+    }
+
+    return 0;
+}
+
+// -----------------------------------------------------------------
+// 4. Function Implementations
+// -----------------------------------------------------------------
+
+// --- Create ---
+
+/**
+ * @brief Creates an empty concurrent map.
+ */
+RBMap* createRBMap() {
+    RBMap* map = (RBMap*)calloc(1, sizeof(RBMap));
+    if (map == NULL) {
+        fprintf(stderr, "Failed to allocate memory for map\n");
+        exit(EXIT_FAILURE);
+    }
+    atomic_init(&map->root, NULL);
+    atomic_init(&map->epoch, 1);
+    atomic_init(&map->numReaders, 0);
+    for (int i = 0; i < MAX_READERS; i++) {
+        atomic_init(&map->readers[i].epoch, EPOCH_OFFLINE);
+    }
+    pthread_mutex_init(&map->writeLock, NULL);
+    return map;
+}
+
+/**
+ * @brief Creates a new RED node private to the current write.
+ */
+CNode* createNode(RBMap* map, int key, int value) {
+    CNode* node = (CNode*)malloc(sizeof(CNode));
+    if (node == NULL) {
+        fprintf(stderr, "Failed to allocate memory for new node\n");
+        exit(EXIT_FAILURE);
+    }
+    node->key = key;
+    node->value = value;
+    node->color = RED; // New nodes are always RED
+    node->stamp = map->writeSeq;
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
+
+// --- Readers ---
+
+/**
+ * @brief Registers the calling thread as a reader and returns its slot id.
+ * The reader starts online.
+ */
+int registerReader(RBMap* map) {
+    int id = atomic_fetch_add(&map->numReaders, 1);
+    if (id >= MAX_READERS) {
+        fprintf(stderr, "Too many readers\n");
+        exit(EXIT_FAILURE);
+    }
+    readerOnline(map, id);
+    return id;
+}
+
+/**
+ * @brief Announces that reader id holds no node pointers.
+ * Two plain moves on x86: an acquire load and a release store to the
+ * reader's own cache line.
+ */
+void readerQuiescent(RBMap* map, int id) {
+    uint64_t e = atomic_load_explicit(&map->epoch, memory_order_acquire);
+    atomic_store_explicit(&map->readers[id].epoch, e, memory_order_release);
+}
+
+/**
+ * @brief Marks a reader as idle so it does not hold back reclamation.
+ */
+void readerOffline(RBMap* map, int id) {
+    atomic_store_explicit(&map->readers[id].epoch, EPOCH_OFFLINE, memory_order_release);
+}
+
+/**
+ * @brief Brings an idle reader back. The fence orders the slot store
+ * before any root load, so a writer that saw us offline has already
+ * published the root we are about to read.
+ */
+void readerOnline(RBMap* map, int id) {
+    atomic_store_explicit(&map->readers[id].epoch, atomic_load(&map->epoch), memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/**
+ * @brief Searches for a key. Lock-free and write-free; the result stays
+ * valid until the caller's next readerQuiescent/readerOffline.
+ */
+CNode* search(RBMap* map, int key) {
+    CNode* current = atomic_load_explicit(&map->root, memory_order_acquire);
+    while (current != NULL && key != current->key) {
+        if (key < current->key) {
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return current;
+}
+
+// --- Writer: copy-on-write and reclamation ---
+
+/**
+ * @brief Makes the node in *slot private to the current write.
+ * A published node is copied and the original retired.
+ */
+CNode* own(RBMap* map, CNode** slot) {
+    CNode* node = *slot;
+    if (node == NULL || node->stamp == map->writeSeq) {
+        return node;
+    }
+    CNode* copy = createNode(map, node->key, node->value);
+    copy->color = node->color;
+    copy->left = node->left;
+    copy->right = node->right;
+    retireNode(map, node);
+    *slot = copy;
+    return copy;
+}
+
+/**
+ * @brief Queues a replaced node; readers may still be looking at it.
+ */
+void retireNode(RBMap* map, CNode* node) {
+    if (map->numRetired == map->capRetired) {
+        map->capRetired = map->capRetired ? map->capRetired * 2 : 64;
+        map->retired = (Retired*)realloc(map->retired, map->capRetired * sizeof(Retired));
+        if (map->retired == NULL) {
+            fprintf(stderr, "Failed to grow retired list\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    map->retired[map->numRetired].node = node;
+    map->retired[map->numRetired].epoch = atomic_load_explicit(&map->epoch, memory_order_relaxed);
+    map->numRetired++;
+}
+
+/**
+ * @brief Frees every retired node that no online reader can still reach.
+ */
+void reclaim(RBMap* map) {
+    uint64_t minEpoch = EPOCH_OFFLINE;
+    int n = atomic_load(&map->numReaders);
+    for (int i = 0; i < n && i < MAX_READERS; i++) {
+        uint64_t e = atomic_load(&map->readers[i].epoch);
+        if (e < minEpoch) minEpoch = e;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < map->numRetired; i++) {
+        if (map->retired[i].epoch < minEpoch) {
+            free(map->retired[i].node);
+        } else {
+            map->retired[kept++] = map->retired[i];
+        }
+    }
+    map->numRetired = kept;
+}
+
+/**
+ * @brief Makes a new root visible to readers, opens a new epoch and reclaims.
+ */
+void publish(RBMap* map, CNode* newRoot) {
+    if (newRoot != NULL) newRoot->color = BLACK;
+    atomic_store(&map->root, newRoot);
+    atomic_fetch_add(&map->epoch, 1);
+    reclaim(map);
+}
+
+// --- Rotations (only ever applied to private nodes) ---
+
+/**
+ * @brief Performs a left rotation on x and returns the new subtree root.
+ */
+CNode* leftRotate(CNode* x) {
+    CNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+/**
+ * @brief Performs a right rotation on y and returns the new subtree root.
+ */
+CNode* rightRotate(CNode* y) {
+    CNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    return x;
+}
+
+/**
+ * @brief Points parent (or the root, if parent is NULL) at newChild instead of oldChild.
+ */
+void replaceChild(CNode** root, CNode* parent, CNode* oldChild, CNode* newChild) {
+    if (parent == NULL) {
+        *root = newChild;
+    } else if (parent->left == oldChild) {
+        parent->left = newChild;
+    } else {
+        parent->right = newChild;
+    }
+}
+
+static Color colorOf(CNode* node) {
+    return node == NULL ? BLACK : node->color;
+}
+
+// --- Insert ---
+
+/**
+ * @brief Inserts key, or replaces its value if it is already present.
+ */
+void insert(RBMap* map, int key, int value) {
+    pthread_mutex_lock(&map->writeLock);
+    map->writeSeq++;
+
+    CNode* newRoot = atomic_load_explicit(&map->root, memory_order_relaxed);
+    if (newRoot == NULL) {
+        publish(map, createNode(map, key, value));
+        pthread_mutex_unlock(&map->writeLock);
+        return;
+    }
+
+    CNode* path[MAX_DEPTH];
+    int depth = 0;
+
+    // 1. Copy the search path
+    path[depth] = own(map, &newRoot);
+    while (path[depth]->key != key) {
+        CNode* cur = path[depth];
+        CNode** slot = (key < cur->key) ? &cur->left : &cur->right;
+        if (*slot == NULL) {
+            *slot = createNode(map, key, value);
+            path[++depth] = *slot;
+            // 2. Fix Red-Black properties on the private path
+            insertFixup(map, &newRoot, path, depth);
+            break;
+        }
+        path[++depth] = own(map, slot);
+    }
+    path[depth]->value = value;
+
+    publish(map, newRoot);
+    pthread_mutex_unlock(&map->writeLock);
+}
+
+/**
+ * @brief Restores Red-Black properties after insertion.
+ * path[0..depth] is the private root-to-z path; path[depth] is z.
+ */
+void insertFixup(RBMap* map, CNode** root, CNode* path[], int depth) {
+    int i = depth;
+    while (i >= 2 && path[i - 1]->color == RED) {
+        CNode* z = path[i];
+        CNode* p = path[i - 1];
+        CNode* g = path[i - 2];
+        CNode* gg = (i >= 3) ? path[i - 3] : NULL;
+
+        if (p == g->left) { // Parent is left child
+            // Case 1: Uncle is RED
+            if (colorOf(g->right) == RED) {
+                own(map, &g->right)->color = BLACK;
+                p->color = BLACK;
+                g->color = RED;
+                i -= 2;
+                continue;
+            }
+            // Case 2: Uncle is BLACK, z is a right child (Triangle)
+            if (z == p->right) {
+                g->left = leftRotate(p);
+                p = z;
+            }
+            // Case 3: Uncle is BLACK, z is a left child (Line)
+            p->color = BLACK;
+            g->color = RED;
+            replaceChild(root, gg, g, rightRotate(g));
+        } else { // Parent is right child (symmetric)
+            // Case 1: Uncle is RED
+            if (colorOf(g->left) == RED) {
+                own(map, &g->left)->color = BLACK;
+                p->color = BLACK;
+                g->color = RED;
+                i -= 2;
+                continue;
+            }
+            // Case 2: Uncle is BLACK, z is a left child (Triangle)
+            if (z == p->left) {
+                g->right = rightRotate(p);
+                p = z;
+            }
+            // Case 3: Uncle is BLACK, z is a right child (Line)
+            p->color = BLACK;
+            g->color = RED;
+            replaceChild(root, gg, g, leftRotate(g));
+        }
+        break;
+    }
+}
+
+// --- Delete ---
+
+/**
+ * @brief Deletes key if present; the unlinked node is retired, not freed.
+ */
+void deleteNode(RBMap* map, int key) {
+    pthread_mutex_lock(&map->writeLock);
+    map->writeSeq++;
+
+    CNode* newRoot = atomic_load_explicit(&map->root, memory_order_relaxed);
+    CNode* probe = newRoot;
+    while (probe != NULL && probe->key != key) {
+        probe = (key < probe->key) ? probe->left : probe->right;
+    }
+    if (probe == NULL) {
+        pthread_mutex_unlock(&map->writeLock);
+        return;
+    }
+
+    CNode* path[MAX_DEPTH];
+    int depth = 0;
+
+    // 1. Copy the path down to z
+    path[depth] = own(map, &newRoot);
+    while (path[depth]->key != key) {
+        CNode* cur = path[depth];
+        path[++depth] = own(map, key < cur->key ? &cur->left : &cur->right);
+    }
+
+    // 2. If z has two children, continue to its successor y and move y's entry up
+    CNode* z = path[depth];
+    if (z->left != NULL && z->right != NULL) {
+        path[++depth] = own(map, &z->right);
+        while (path[depth]->left != NULL) {
+            CNode* cur = path[depth];
+            path[++depth] = own(map, &cur->left);
+        }
+        z->key = path[depth]->key;
+        z->value = path[depth]->value;
+    }
+
+    // 3. Unlink y (now at most one child); x takes its place
+    CNode* y = path[depth];
+    CNode* x = (y->left != NULL) ? y->left : y->right;
+    CNode* parent = (depth > 0) ? path[depth - 1] : NULL;
+    int xIsLeft = (parent != NULL && parent->left == y);
+    replaceChild(&newRoot, parent, y, x);
+    Color y_original_color = y->color;
+    free(y); // y is a private copy; the published original was retired by own()
+
+    // 4. Fix Red-Black properties if a BLACK node was removed
+    if (y_original_color == BLACK) {
+        if (colorOf(x) == RED) {
+            own(map, parent == NULL ? &newRoot : (xIsLeft ? &parent->left : &parent->right))->color = BLACK;
+        } else {
+            deleteFixup(map, &newRoot, path, depth - 1, x, xIsLeft);
+        }
+    }
+
+    publish(map, newRoot);
+    pthread_mutex_unlock(&map->writeLock);
+}
+
+/**
+ * @brief Restores Red-Black properties after deletion.
+ * x is a doubly-black child of path[k] on the side given by xIsLeft.
+ */
+void deleteFixup(RBMap* map, CNode** root, CNode* path[], int k, CNode* x, int xIsLeft) {
+    while (k >= 0 && colorOf(x) == BLACK) {
+        CNode* p = path[k];
+        CNode* pp = (k > 0) ? path[k - 1] : NULL;
+
+        if (xIsLeft) {
+            CNode* w = own(map, &p->right); // Sibling
+
+            // Case 1: Sibling w is RED
+            if (w->color == RED) {
+                w->color = BLACK;
+                p->color = RED;
+                replaceChild(root, pp, p, leftRotate(p));
+                path[k] = w;
+                path[++k] = p;
+                pp = w;
+                w = own(map, &p->right);
+            }
+
+            // Case 2: Sibling w is BLACK, both w's children are BLACK
+            if (colorOf(w->left) == BLACK && colorOf(w->right) == BLACK) {
+                w->color = RED;
+                x = p;
+                k--;
+                xIsLeft = (pp != NULL && pp->left == p);
+            } else {
+                // Case 3: Sibling w is BLACK, w.left is RED, w.right is BLACK
+                if (colorOf(w->right) == BLACK) {
+                    own(map, &w->left)->color = BLACK;
+                    w->color = RED;
+                    w = p->right = rightRotate(w);
+                }
+
+                // Case 4: Sibling w is BLACK, w.right is RED
+                w->color = p->color;
+                p->color = BLACK;
+                own(map, &w->right)->color = BLACK;
+                replaceChild(root, pp, p, leftRotate(p));
+                return; // Fixup complete
+            }
+        } else { // Symmetric cases: x is a right child
+            CNode* w = own(map, &p->left); // Sibling
+
+            // Case 1: Sibling w is RED
+            if (w->color == RED) {
+                w->color = BLACK;
+                p->color = RED;
+                replaceChild(root, pp, p, rightRotate(p));
+                path[k] = w;
+                path[++k] = p;
+                pp = w;
+                w = own(map, &p->left);
+            }
+
+            // Case 2: Sibling w is BLACK, both w's children are BLACK
+            if (colorOf(w->left) == BLACK && colorOf(w->right) == BLACK) {
+                w->color = RED;
+                x = p;
+                k--;
+                xIsLeft = (pp != NULL && pp->left == p);
+            } else {
+                // Case 3: Sibling w is BLACK, w.left is BLACK, w.right is RED
+                if (colorOf(w->left) == BLACK) {
+                    own(map, &w->right)->color = BLACK;
+                    w->color = RED;
+                    w = p->left = leftRotate(w);
+                }
+
+                // Case 4: Sibling w is BLACK, w.left is RED
+                w->color = p->color;
+                p->color = BLACK;
+                own(map, &w->left)->color = BLACK;
+                replaceChild(root, pp, p, rightRotate(p));
+                return; // Fixup complete
+            }
+        }
+    }
+    // x is a private path node here (or the root)
+    if (x != NULL) x->color = BLACK;
+}
+
+// --- Print ---
+
+/**
+ * @brief Prints the current version inorder (key=value).
+ */
+void inorder(RBMap* map) {
+    printf("Inorder Traversal: ");
+    inorderHelper(atomic_load(&map->root));
+    printf("\n");
+}
+
+/**
+ * @brief Recursive helper for inorder traversal.
+ */
+void inorderHelper(CNode* node) {
+    if (node != NULL) {
+        inorderHelper(node->left);
+        printf("%d=%d(%c) ", node->key, node->value, (node->color == RED ? 'R' : 'B'));
+        inorderHelper(node->right);
+    }
+}
+
+// --- Free (Cleanup) ---
+
+/**
+ * @brief Frees the map. No reader may be running.
+ */
+void freeRBMap(RBMap* map) {
+    if (map == NULL) return;
+    freeTreeHelper(atomic_load(&map->root));
+    for (size_t i = 0; i < map->numRetired; i++) {
+        free(map->retired[i].node);
+    }
+    free(map->retired);
+    pthread_mutex_destroy(&map->writeLock);
+    free(map);
+}
+
+/**
+ * @brief Recursive helper to free all nodes.
+ */
+void freeTreeHelper(CNode* node) {
+    if (node != NULL) {
+        freeTreeHelper(node->left);
+        freeTreeHelper(node->right);
+        free(node);
+    }
+}
+
+// -----------------------------------------------------------------
+// 5. Benchmark
+// -----------------------------------------------------------------
+
+#define BENCH_KEYS (1 << 16)
+#define QUIESCE_EVERY 64
+
+typedef struct {
+    RBMap* map;
+    pthread_rwlock_t* rwlock;   // NULL for the epoch-based read path
+    _Atomic int* stop;
+    unsigned int seed;
+    long ops;
+    long hits;
+} BenchArgs;
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void* readerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    int id = a->rwlock ? -1 : registerReader(a->map);
+    long ops = 0, hits = 0;
+    while (!atomic_load_explicit(a->stop, memory_order_relaxed)) {
+        int key = rand_r(&a->seed) % (2 * BENCH_KEYS);
+        if (a->rwlock) pthread_rwlock_rdlock(a->rwlock);
+        hits += (search(a->map, key) != NULL);
+        if (a->rwlock) pthread_rwlock_unlock(a->rwlock);
+        if (++ops % QUIESCE_EVERY == 0 && id >= 0) readerQuiescent(a->map, id);
+    }
+    if (id >= 0) readerOffline(a->map, id);
+    a->ops = ops;
+    a->hits = hits;
+    return NULL;
+}
+
+static void* writerThread(void* arg) {
+    BenchArgs* a = (BenchArgs*)arg;
+    long ops = 0;
+    while (!atomic_load_explicit(a->stop, memory_order_relaxed)) {
+        int key = rand_r(&a->seed) % (2 * BENCH_KEYS);
+        if (a->rwlock) pthread_rwlock_wrlock(a->rwlock);
+        if (ops & 1) deleteNode(a->map, key);
+        else insert(a->map, key, key);
+        if (a->rwlock) pthread_rwlock_unlock(a->rwlock);
+        ops++;
+    }
+    a->ops = ops;
+    return NULL;
+}
+
+/**
+ * @brief Runs numReaders searching threads against one updating writer and
+ * prints aggregate reader throughput. With useRwLock every search and update
+ * also takes a pthread_rwlock, which is what a single-threaded tree needs.
+ */
+void benchmark(int useRwLock, int numReaders, double seconds) {
+    RBMap* map = createRBMap();
+    for (int i = 0; i < BENCH_KEYS; i++) {
+        insert(map, (i * 2654435761u) % (2 * BENCH_KEYS), i);
+    }
+
+    pthread_rwlock_t rwlock;
+    pthread_rwlock_init(&rwlock, NULL);
+    _Atomic int stop;
+    atomic_init(&stop, 0);
+
+    pthread_t threads[MAX_READERS + 1];
+    BenchArgs args[MAX_READERS + 1];
+    for (int i = 0; i <= numReaders; i++) {
+        args[i].map = map;
+        args[i].rwlock = useRwLock ? &rwlock : NULL;
+        args[i].stop = &stop;
+        args[i].seed = 1234u + i;
+        args[i].ops = 0;
+        args[i].hits = 0;
+    }
+
+    double start = nowSeconds();
+    pthread_create(&threads[0], NULL, writerThread, &args[0]);
+    for (int i = 1; i <= numReaders; i++) {
+        pthread_create(&threads[i], NULL, readerThread, &args[i]);
+    }
+    struct timespec pause = { (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9) };
+    nanosleep(&pause, NULL);
+    atomic_store(&stop, 1);
+    for (int i = 0; i <= numReaders; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    long readOps = 0;
+    for (int i = 1; i <= numReaders; i++) readOps += args[i].ops;
+    printf("%22.2f ", readOps / elapsed / 1e6);
+
+    pthread_rwlock_destroy(&rwlock);
+    freeRBMap(map);
+}
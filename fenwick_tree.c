@@ -0,0 +1,326 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Benchmarked against segment_tree.c (include idiom: see its main)
+#define main segmentTreeDemo
+#include "segment_tree.c"
+#undef main
+
+// Fenwick tree (binary indexed tree) over long long values. tree[i]
+// (1-based) holds the sum of the (i & -i) elements ending at position i,
+// so prefix sums and point updates each touch O(log n) words, and the
+// whole structure is n + 1 words instead of the segment tree's 4n.
+typedef struct {
+    long long* tree;
+    int n;
+} FenwickTree;
+
+/**
+ * @brief Builds a Fenwick tree in O(n): every node pushes its total into
+ *        the next node that covers it.
+ * @param arr The input array (may be NULL for all zeros)
+ * @param n Size of the input array
+ * @return A new, initialized FenwickTree
+ */
+FenwickTree createFenwickTree(const long long arr[], int n) {
+    FenwickTree ft;
+    ft.n = n;
+    ft.tree = (long long*)calloc(n + 1, sizeof(long long));
+    if (ft.tree == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    if (arr != NULL) {
+        memcpy(ft.tree + 1, arr, sizeof(long long) * n);
+    }
+    for (int i = 1; i <= n; i++) {
+        int parent = i + (i & -i);
+        if (parent <= n) {
+            ft.tree[parent] += ft.tree[i];
+        }
+    }
+    return ft;
+}
+
+/**
+ * @brief Adds delta to element idx.
+ */
+void fenwick_add(FenwickTree* ft, int idx, long long delta) {
+    if (idx < 0 || idx > ft->n - 1) {
+        fprintf(stderr, "Invalid update index\n");
+        return;
+    }
+    for (int i = idx + 1; i <= ft->n; i += i & -i) {
+        ft->tree[i] += delta;
+    }
+}
+
+/**
+ * @brief Sum of elements [0, idx]; 0 for idx < 0.
+ */
+long long fenwick_prefix_sum(const FenwickTree* ft, int idx) {
+    if (idx > ft->n - 1) {
+        idx = ft->n - 1;
+    }
+    long long sum = 0;
+    for (int i = idx + 1; i > 0; i -= i & -i) {
+        sum += ft->tree[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Sum of elements [L, R].
+ */
+long long fenwick_range_sum(const FenwickTree* ft, int L, int R) {
+    if (L < 0 || R > ft->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    return fenwick_prefix_sum(ft, R) - fenwick_prefix_sum(ft, L - 1);
+}
+
+/**
+ * @brief Smallest idx with prefix_sum(idx) >= target, by descending the
+ *        implicit tree one bit at a time (O(log n), no inner search).
+ *        Requires non-negative elements.
+ * @return The index, or n if the total is below target
+ */
+int fenwick_lower_bound(const FenwickTree* ft, long long target) {
+    if (target <= 0) {
+        return 0;
+    }
+    int step = 1;
+    while (step * 2 <= ft->n) {
+        step *= 2;
+    }
+    int pos = 0; // Largest position whose prefix sum is still < target
+    for (; step > 0; step >>= 1) {
+        if (pos + step <= ft->n && ft->tree[pos + step] < target) {
+            pos += step;
+            target -= ft->tree[pos];
+        }
+    }
+    return pos; // The answer is 1-based position pos + 1, i.e. 0-based pos
+}
+
+/**
+ * @brief Frees all allocated memory for the Fenwick tree.
+ */
+void freeFenwickTree(FenwickTree* ft) {
+    free(ft->tree);
+    ft->tree = NULL;
+    ft->n = 0;
+}
+
+// --- Range update, range query ---
+
+// Two Fenwick trees over the difference array d (a[i] = d[0] + ... + d[i]):
+// b1 holds d[i] and b2 holds d[i] * i, so
+//   a[0] + ... + a[i] = (i + 1) * sum(b1, i) - sum(b2, i).
+typedef struct {
+    FenwickTree b1;
+    FenwickTree b2;
+} RangeFenwick;
+
+/**
+ * @brief Builds a range-update Fenwick tree over arr in O(n).
+ */
+RangeFenwick createRangeFenwick(const long long arr[], int n) {
+    long long* d1 = (long long*)calloc(n, sizeof(long long));
+    long long* d2 = (long long*)calloc(n, sizeof(long long));
+    if (d1 == NULL || d2 == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (int i = 0; arr != NULL && i < n; i++) {
+        d1[i] = arr[i] - (i > 0 ? arr[i - 1] : 0);
+        d2[i] = d1[i] * i;
+    }
+    RangeFenwick rf;
+    rf.b1 = createFenwickTree(d1, n);
+    rf.b2 = createFenwickTree(d2, n);
+    free(d1);
+    free(d2);
+    return rf;
+}
+
+/**
+ * @brief Adds delta to every element in [L, R] in O(log n).
+ */
+void range_fenwick_add(RangeFenwick* rf, int L, int R, long long delta) {
+    if (L < 0 || R > rf->b1.n - 1 || L > R) {
+        fprintf(stderr, "Invalid update range\n");
+        return;
+    }
+    fenwick_add(&rf->b1, L, delta);
+    fenwick_add(&rf->b2, L, delta * L);
+    if (R + 1 < rf->b1.n) {
+        fenwick_add(&rf->b1, R + 1, -delta);
+        fenwick_add(&rf->b2, R + 1, -delta * (R + 1));
+    }
+}
+
+static long long rangeFenwickPrefix(const RangeFenwick* rf, int idx) {
+    if (idx < 0) {
+        return 0;
+    }
+    return fenwick_prefix_sum(&rf->b1, idx) * (idx + 1) - fenwick_prefix_sum(&rf->b2, idx);
+}
+
+/**
+ * @brief Sum of elements [L, R] in O(log n).
+ */
+long long range_fenwick_sum(const RangeFenwick* rf, int L, int R) {
+    if (L < 0 || R > rf->b1.n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    return rangeFenwickPrefix(rf, R) - rangeFenwickPrefix(rf, L - 1);
+}
+
+void freeRangeFenwick(RangeFenwick* rf) {
+    freeFenwickTree(&rf->b1);
+    freeFenwickTree(&rf->b2);
+}
+
+// --- Benchmark against segment_tree.c ---
+
+/**
+ * @brief Runs one trace of point updates and range sums through the
+ *        recursive and iterative segment trees and the Fenwick tree,
+ *        then one trace of range adds and range sums through the lazy
+ *        segment tree and the two-BIT tree.
+ * @param n Number of elements
+ * @param ops Number of operations of each kind
+ */
+void benchmarkFenwick(int n, int ops) {
+    int* arr = (int*)malloc(sizeof(int) * n);
+    long long* wide = (long long*)malloc(sizeof(long long) * n);
+    int* Ls = (int*)malloc(sizeof(int) * ops);
+    int* Rs = (int*)malloc(sizeof(int) * ops);
+    int* vals = (int*)malloc(sizeof(int) * ops);
+    for (int i = 0; i < n; i++) {
+        arr[i] = rand() % 10; // Keeps segment_tree.c's int sums in range
+        wide[i] = arr[i];
+    }
+    for (int i = 0; i < ops; i++) {
+        int a = rand() % n, b = rand() % n;
+        Ls[i] = a < b ? a : b;
+        Rs[i] = a < b ? b : a;
+        vals[i] = rand() % 10;
+    }
+
+    double ns = 1e9 / CLOCKS_PER_SEC;
+    long long check[3] = {0, 0, 0};
+    double build[3], upd[3], qry[3];
+
+    // Point update (set) + range sum
+    clock_t t0 = clock();
+    SegmentTree rec = createSegmentTree(arr, n);
+    clock_t t1 = clock();
+    for (int i = 0; i < ops; i++) update(&rec, Ls[i], vals[i]);
+    clock_t t2 = clock();
+    for (int i = 0; i < ops; i++) check[0] += query(&rec, Ls[i], Rs[i]);
+    clock_t t3 = clock();
+    build[0] = (t1 - t0) * ns / n; upd[0] = (t2 - t1) * ns / ops; qry[0] = (t3 - t2) * ns / ops;
+    freeSegmentTree(&rec);
+
+    t0 = clock();
+    IterSegmentTree it = createIterSegmentTree(arr, n);
+    t1 = clock();
+    for (int i = 0; i < ops; i++) iterUpdate(&it, Ls[i], vals[i]);
+    t2 = clock();
+    for (int i = 0; i < ops; i++) check[1] += iterQuery(&it, Ls[i], Rs[i]);
+    t3 = clock();
+    build[1] = (t1 - t0) * ns / n; upd[1] = (t2 - t1) * ns / ops; qry[1] = (t3 - t2) * ns / ops;
+    freeIterSegmentTree(&it);
+
+    t0 = clock();
+    FenwickTree ft = createFenwickTree(wide, n);
+    t1 = clock();
+    for (int i = 0; i < ops; i++) {
+        // A Fenwick tree stores no elements, so a set is an add of the difference
+        fenwick_add(&ft, Ls[i], vals[i] - wide[Ls[i]]);
+        wide[Ls[i]] = vals[i];
+    }
+    t2 = clock();
+    for (int i = 0; i < ops; i++) check[2] += fenwick_range_sum(&ft, Ls[i], Rs[i]);
+    t3 = clock();
+    build[2] = (t1 - t0) * ns / n; upd[2] = (t2 - t1) * ns / ops; qry[2] = (t3 - t2) * ns / ops;
+    freeFenwickTree(&ft);
+
+    const char* names[] = {"segment (recursive)", "segment (iterative)", "fenwick"};
+    printf("n = %d, point update + range sum%s\n", n,
+           check[0] == check[1] && check[1] == check[2] ? "" : " (MISMATCH)");
+    for (int k = 0; k < 3; k++) {
+        printf("  %-20s build %6.2f ns/elem  update %6.1f ns  query %6.1f ns\n",
+               names[k], build[k], upd[k], qry[k]);
+    }
+
+    // Range add + range sum. Each range gets +1 and then -1 on the next
+    // step, which keeps segment_tree.c's int sums in range.
+    for (int i = 0; i < n; i++) wide[i] = arr[i];
+    SegmentTree lazy = createSegmentTree(arr, n);
+    RangeFenwick rf = createRangeFenwick(wide, n);
+    long long lazyCheck = 0, rfCheck = 0;
+    t0 = clock();
+    for (int i = 0; i < ops; i++) {
+        int j = i & ~1;
+        range_add(&lazy, Ls[j], Rs[j], (i & 1) ? -1 : 1);
+        lazyCheck += query(&lazy, Ls[(i + 1) % ops], Rs[(i + 1) % ops]);
+    }
+    t1 = clock();
+    for (int i = 0; i < ops; i++) {
+        int j = i & ~1;
+        range_fenwick_add(&rf, Ls[j], Rs[j], (i & 1) ? -1 : 1);
+        rfCheck += range_fenwick_sum(&rf, Ls[(i + 1) % ops], Rs[(i + 1) % ops]);
+    }
+    t2 = clock();
+    printf("  range add + range sum: lazy segment %6.1f ns/pair, two-BIT %6.1f ns/pair%s\n",
+           (t1 - t0) * ns / ops, (t2 - t1) * ns / ops, lazyCheck == rfCheck ? "" : " (MISMATCH)");
+    freeSegmentTree(&lazy);
+    freeRangeFenwick(&rf);
+
+    free(arr);
+    free(wide);
+    free(Ls);
+    free(Rs);
+    free(vals);
+}
+
+// --- Example Usage ---
+int main() {
+    long long arr[] = {1, 3, 5, 7, 9, 11};
+    int n = sizeof(arr) / sizeof(arr[0]);
+
+    FenwickTree ft = createFenwickTree(arr, n);
+    printf("Sum of range [1, 3] is: %lld\n", fenwick_range_sum(&ft, 1, 3)); // 15
+
+    fenwick_add(&ft, 2, 1); // arr[2] = 6
+    printf("Sum of range [1, 3] after update: %lld\n", fenwick_range_sum(&ft, 1, 3)); // 16
+
+    // Prefix sums are 1, 4, 10, 17, 26, 37
+    printf("lower_bound(10) = %d, lower_bound(11) = %d, lower_bound(38) = %d\n",
+           fenwick_lower_bound(&ft, 10), fenwick_lower_bound(&ft, 11),
+           fenwick_lower_bound(&ft, 38)); // 2, 3, 6
+    freeFenwickTree(&ft);
+
+    RangeFenwick rf = createRangeFenwick(arr, n);
+    range_fenwick_add(&rf, 0, 2, 10); // {11, 13, 15, 7, 9, 11}
+    printf("Sum of range [1, 3] after adding 10 to [0, 2]: %lld\n",
+           range_fenwick_sum(&rf, 1, 3)); // 35
+    freeRangeFenwick(&rf);
+
+    printf("\n");
+    srand(42);
+    int sizes[] = {1000, 100000, 10000000};
+    for (int s = 0; s < 3; s++) {
+        benchmarkFenwick(sizes[s], 1000000);
+    }
+
+    return 0;
+}
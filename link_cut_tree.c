@@ -0,0 +1,305 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<limits.h>
+#include<time.h>
+
+// Link-cut trees (Sleator & Tarjan) for a dynamic forest with weighted
+// edges: link, cut, find_root and "heaviest edge on the path u..v" all
+// run in O(log n) amortized.
+//
+// Each preferred path of the forest is kept in a splay tree ordered by
+// depth; the splay trees are the rotations from splay_tree.c with parent
+// links added. A splay root's parent pointer is the "path-parent" link to
+// the node above its path, so a node is a splay root when its parent does
+// not list it as a child. Edges are nodes too (between their endpoints),
+// which lets the path aggregate be a plain maximum over node weights.
+
+typedef struct LCNode {
+    long long weight;       // Edge weight; LLONG_MIN for vertices
+    struct LCNode* maxNode; // Heaviest node in this splay subtree
+    int reversed;           // Pending reverse for both children
+    int id;                 // Vertex id, or vertices + edge id
+    struct LCNode* left;
+    struct LCNode* right;
+    struct LCNode* parent;
+} LCNode;
+
+typedef struct {
+    LCNode* nodes;          // [0, vertices) vertices, then one slot per edge
+    int vertices;
+    int maxEdges;
+    int* edgeU;             // Endpoints of each edge slot (-1 = free)
+    int* edgeV;
+    int* freeEdges;         // Stack of unused edge slots
+    int numFree;
+    LCNode** stack;         // Scratch for pushing tags top-down in splay
+} LinkCutForest;
+
+LinkCutForest* createForest(int vertices, int maxEdges) {
+    LinkCutForest* f = (LinkCutForest*)malloc(sizeof(LinkCutForest));
+    int total = vertices + maxEdges;
+    f->nodes = (LCNode*)calloc(total, sizeof(LCNode));
+    f->vertices = vertices;
+    f->maxEdges = maxEdges;
+    f->edgeU = (int*)malloc(sizeof(int) * maxEdges);
+    f->edgeV = (int*)malloc(sizeof(int) * maxEdges);
+    f->freeEdges = (int*)malloc(sizeof(int) * maxEdges);
+    f->stack = (LCNode**)malloc(sizeof(LCNode*) * total);
+    for (int i = 0; i < total; i++) {
+        f->nodes[i].id = i;
+        f->nodes[i].weight = LLONG_MIN;
+        f->nodes[i].maxNode = &f->nodes[i];
+    }
+    f->numFree = 0;
+    for (int e = maxEdges - 1; e >= 0; e--) {
+        f->edgeU[e] = f->edgeV[e] = -1;
+        f->freeEdges[f->numFree++] = e;
+    }
+    return f;
+}
+
+void freeForest(LinkCutForest* f) {
+    free(f->nodes);
+    free(f->edgeU);
+    free(f->edgeV);
+    free(f->freeEdges);
+    free(f->stack);
+    free(f);
+}
+
+// --- Splay trees over preferred paths ---
+
+static int isSplayRoot(LCNode* x) {
+    return x->parent == NULL || (x->parent->left != x && x->parent->right != x);
+}
+
+static void pull(LCNode* x) {
+    x->maxNode = x;
+    if (x->left && x->left->maxNode->weight > x->maxNode->weight) x->maxNode = x->left->maxNode;
+    if (x->right && x->right->maxNode->weight > x->maxNode->weight) x->maxNode = x->right->maxNode;
+}
+
+static void applyReverse(LCNode* x) {
+    if (x == NULL) return;
+    LCNode* temp = x->left;
+    x->left = x->right;
+    x->right = temp;
+    x->reversed ^= 1;
+}
+
+static void pushDown(LCNode* x) {
+    if (x->reversed) {
+        applyReverse(x->left);
+        applyReverse(x->right);
+        x->reversed = 0;
+    }
+}
+
+// Rotate x above its parent (rightRotate/leftRotate of the parent),
+// keeping the path-parent link on whichever node ends up on top
+static void rotate(LCNode* x) {
+    LCNode* p = x->parent;
+    LCNode* g = p->parent;
+    int pWasRoot = isSplayRoot(p);
+
+    if (x == p->left) {
+        p->left = x->right;
+        if (x->right) x->right->parent = p;
+        x->right = p;
+    }
+    else {
+        p->right = x->left;
+        if (x->left) x->left->parent = p;
+        x->left = p;
+    }
+    p->parent = x;
+    x->parent = g;
+    if (!pWasRoot) {
+        if (g->left == p) g->left = x;
+        else g->right = x;
+    }
+
+    pull(p);
+    pull(x);
+}
+
+// Splay x to the root of its splay tree. Reverse tags above x are pushed
+// down first, top to bottom, so the rotations see correct child order.
+static void splay(LinkCutForest* f, LCNode* x) {
+    int top = 0;
+    LCNode* y = x;
+    f->stack[top++] = y;
+    while (!isSplayRoot(y)) {
+        y = y->parent;
+        f->stack[top++] = y;
+    }
+    while (top > 0) pushDown(f->stack[--top]);
+
+    while (!isSplayRoot(x)) {
+        LCNode* p = x->parent;
+        if (!isSplayRoot(p)) {
+            if ((p->parent->left == p) == (p->left == x))
+                rotate(p); // Zig-zig
+            else
+                rotate(x); // Zig-zag
+        }
+        rotate(x);
+    }
+}
+
+// --- Link-cut operations ---
+
+// Make the root-to-x path preferred: afterwards x is the root of a splay
+// tree holding exactly the path from its tree root down to x
+static void access(LinkCutForest* f, LCNode* x) {
+    LCNode* last = NULL;
+    for (LCNode* y = x; y != NULL; y = y->parent) {
+        splay(f, y);
+        y->right = last;
+        pull(y);
+        last = y;
+    }
+    splay(f, x);
+}
+
+// Re-root x's tree at x (reverse the root-to-x path)
+static void makeRoot(LinkCutForest* f, LCNode* x) {
+    access(f, x);
+    applyReverse(x);
+}
+
+static LCNode* findRootNode(LinkCutForest* f, LCNode* x) {
+    access(f, x);
+    while (1) {
+        pushDown(x);
+        if (x->left == NULL) break;
+        x = x->left;
+    }
+    splay(f, x); // Keep the amortized bound
+    return x;
+}
+
+// Root vertex of u's tree
+int find_root(LinkCutForest* f, int u) {
+    return findRootNode(f, &f->nodes[u])->id;
+}
+
+int connected(LinkCutForest* f, int u, int v) {
+    return findRootNode(f, &f->nodes[u]) == findRootNode(f, &f->nodes[v]);
+}
+
+// Hang the tree rooted at a (after re-rooting) below b
+static void linkNodes(LinkCutForest* f, LCNode* a, LCNode* b) {
+    makeRoot(f, a);
+    a->parent = b;
+}
+
+// Remove the tree edge between adjacent nodes a and b
+static void cutNodes(LinkCutForest* f, LCNode* a, LCNode* b) {
+    makeRoot(f, a);
+    access(f, b);
+    // The path is exactly a-b, so a is b's left child in the splay tree
+    b->left->parent = NULL;
+    b->left = NULL;
+    pull(b);
+}
+
+// Add edge u-v with the given weight. Returns its edge id, or -1 if u and
+// v are already connected (the forest must stay acyclic) or no slot is free.
+int link(LinkCutForest* f, int u, int v, long long weight) {
+    if (f->numFree == 0 || connected(f, u, v)) return -1;
+
+    int e = f->freeEdges[--f->numFree];
+    LCNode* edge = &f->nodes[f->vertices + e];
+    edge->weight = weight;
+    edge->left = edge->right = edge->parent = NULL;
+    edge->reversed = 0;
+    edge->maxNode = edge;
+    f->edgeU[e] = u;
+    f->edgeV[e] = v;
+
+    linkNodes(f, &f->nodes[u], edge);
+    linkNodes(f, edge, &f->nodes[v]);
+    return e;
+}
+
+// Remove edge e (as returned by link). Returns 0, or -1 if e is not a
+// live edge: out of range, never linked, or already cut.
+int cut(LinkCutForest* f, int e) {
+    if (e < 0 || e >= f->maxEdges || f->edgeU[e] < 0) return -1;
+
+    LCNode* edge = &f->nodes[f->vertices + e];
+    cutNodes(f, &f->nodes[f->edgeU[e]], edge);
+    cutNodes(f, edge, &f->nodes[f->edgeV[e]]);
+    f->edgeU[e] = f->edgeV[e] = -1;
+    f->freeEdges[f->numFree++] = e;
+    return 0;
+}
+
+// Heaviest edge on the path u..v: returns its weight and stores its id in
+// *edge. Returns LLONG_MIN (and -1) if u == v or they are not connected.
+long long pathMax(LinkCutForest* f, int u, int v, int* edge) {
+    *edge = -1;
+    if (u == v || !connected(f, u, v)) return LLONG_MIN;
+    makeRoot(f, &f->nodes[u]);
+    access(f, &f->nodes[v]);
+    LCNode* heaviest = f->nodes[v].maxNode; // v's splay tree is the u..v path
+    *edge = heaviest->id - f->vertices;
+    return heaviest->weight;
+}
+
+int main() {
+    // Services 0..6; edge weights are link latencies in microseconds
+    LinkCutForest* f = createForest(7, 16);
+    int ab = link(f, 0, 1, 120);
+    link(f, 1, 2, 40);
+    link(f, 1, 3, 300);
+    link(f, 3, 4, 80);
+    link(f, 4, 5, 15);
+    printf("link(5, 0) while connected: %d\n", link(f, 5, 0, 1));
+
+    int e;
+    long long w = pathMax(f, 2, 5, &e);
+    printf("Route 2..5: slowest hop %d-%d, %lld us\n", f->edgeU[e], f->edgeV[e], w);
+    printf("find_root(5) = %d, connected(0, 6) = %d\n", find_root(f, 5), connected(f, 0, 6));
+
+    printf("\nCutting 1-3 and adding 2-6, 6-4\n");
+    cut(f, 2); // The 1-3 edge
+    link(f, 2, 6, 60);
+    link(f, 6, 4, 90);
+    w = pathMax(f, 0, 5, &e);
+    printf("Route 0..5: slowest hop %d-%d, %lld us\n", f->edgeU[e], f->edgeV[e], w);
+    cut(f, ab);
+    printf("After cutting 0-1: connected(0, 5) = %d\n", connected(f, 0, 5));
+    printf("Cutting 0-1 again: %d\n", cut(f, ab));
+    freeForest(f);
+
+    // Random spanning tree, then a mix of edge swaps (cut + relink) and path queries
+    int n = 100000, ops = 1000000;
+    f = createForest(n, n - 1);
+    int* live = (int*)malloc(sizeof(int) * n);
+    srand(42);
+    for (int i = 1; i < n; i++) live[i - 1] = link(f, i, rand() % i, rand() % 1000);
+    long long checksum = 0;
+    clock_t t0 = clock();
+    for (int i = 0; i < ops; i++) {
+        if (rand() % 3 == 0) {
+            // After the cut, w is on exactly one side, so one of the links succeeds
+            int k = rand() % (n - 1);
+            int a = f->edgeU[live[k]], b = f->edgeV[live[k]], w = rand() % n;
+            cut(f, live[k]);
+            live[k] = link(f, a, w, rand() % 1000);
+            if (live[k] < 0) live[k] = link(f, b, w, rand() % 1000);
+        }
+        else {
+            long long heaviest = pathMax(f, rand() % n, rand() % n, &e);
+            if (heaviest != LLONG_MIN) checksum += heaviest;
+        }
+    }
+    clock_t t1 = clock();
+    printf("\n%d random swaps/queries on %d vertices: %.1f ns/op (checksum %lld)\n",
+           ops, n, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / ops, checksum);
+    free(live);
+    freeForest(f);
+    return 0;
+}
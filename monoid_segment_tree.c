@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+
+// -----------------------------------------------------------------
+// 1. Generic Segment Tree Template
+// -----------------------------------------------------------------
+
+// A segment tree over any monoid (an associative COMBINE with an
+// IDENTITY element), instantiated per operation with a macro the same
+// way red_black_map.c instantiates maps. segment_tree.c hard-wires int
+// sums; here the element type and the operation are parameters, and
+// COMBINE is expanded at every call site, so the compiler inlines it
+// instead of calling through a function pointer.
+//
+// The layout is the iterative one from segment_tree.c with the leaf count
+// rounded up to a power of two (padding leaves hold IDENTITY). Queries
+// keep separate left and right accumulators, so COMBINE need not be
+// commutative: matrix products come out in index order.
+//
+//   DEFINE_SEGMENT_TREE(SumTree, long long, 0LL, SUM_COMBINE)
+//
+// generates SumTree and SumTree_create/query/update/free. IDENTITY
+// is any expression of type T; COMBINE(a, b) must return a T and may
+// evaluate its arguments more than once (the template never passes
+// arguments with side effects).
+
+#define DEFINE_SEGMENT_TREE(NAME, T, IDENTITY, COMBINE)                       \
+                                                                              \
+typedef struct NAME {                                                         \
+    T* tree;                                                                  \
+    int n;                                                                    \
+    int size;                                                                 \
+} NAME;                                                                       \
+                                                                              \
+/* Builds the tree over arr[0, n) in O(n). */                                 \
+static inline NAME NAME##_create(const T arr[], int n) {                      \
+    NAME st;                                                                  \
+    st.n = n;                                                                 \
+    st.size = 1;                                                              \
+    while (st.size < n) st.size *= 2;                                         \
+    st.tree = (T*)malloc(sizeof(T) * 2 * st.size);                            \
+    if (st.tree == NULL) {                                                    \
+        fprintf(stderr, "Memory allocation failed\n");                        \
+        exit(EXIT_FAILURE);                                                   \
+    }                                                                         \
+    for (int i = 0; i < st.size; i++)                                         \
+        st.tree[st.size + i] = i < n ? arr[i] : (IDENTITY);                   \
+    for (int i = st.size - 1; i > 0; i--)                                     \
+        st.tree[i] = COMBINE(st.tree[2 * i], st.tree[2 * i + 1]);             \
+    return st;                                                                \
+}                                                                             \
+                                                                              \
+/* Combination of arr[L..R] in order; IDENTITY for an invalid range. */       \
+static inline T NAME##_query(const NAME* st, int L, int R) {                  \
+    if (L < 0 || R > st->n - 1 || L > R) {                                    \
+        fprintf(stderr, "Invalid query range\n");                             \
+        return (IDENTITY);                                                    \
+    }                                                                         \
+    T left = (IDENTITY), right = (IDENTITY);                                  \
+    for (L += st->size, R += st->size + 1; L < R; L >>= 1, R >>= 1) {         \
+        if (L & 1) {                                                          \
+            left = COMBINE(left, st->tree[L]);                                \
+            L++;                                                              \
+        }                                                                     \
+        if (R & 1) {                                                          \
+            R--;                                                              \
+            right = COMBINE(st->tree[R], right);                              \
+        }                                                                     \
+    }                                                                         \
+    return COMBINE(left, right);                                              \
+}                                                                             \
+                                                                              \
+/* Sets arr[idx] = value and recombines its ancestors. */                     \
+static inline void NAME##_update(NAME* st, int idx, T value) {                \
+    if (idx < 0 || idx > st->n - 1) {                                         \
+        fprintf(stderr, "Invalid update index\n");                            \
+        return;                                                               \
+    }                                                                         \
+    int i = idx + st->size;                                                   \
+    st->tree[i] = value;                                                      \
+    for (i >>= 1; i > 0; i >>= 1)                                             \
+        st->tree[i] = COMBINE(st->tree[2 * i], st->tree[2 * i + 1]);          \
+}                                                                             \
+                                                                              \
+static inline void NAME##_free(NAME* st) {                                    \
+    free(st->tree);                                                           \
+    st->tree = NULL;                                                          \
+    st->n = st->size = 0;                                                     \
+}
+
+
+// Search on top of an instantiated tree: the first index where the running
+// combination from L satisfies COND(acc, x). COND must be monotone (once
+// true for a prefix, true for every longer one), e.g. "max >= x" or
+// "sum >= k" over non-negative values. One climb and one descent, so
+// O(log n) instead of an outer binary search over NAME_query.
+//
+//   DEFINE_SEGMENT_TREE_SEARCH(MaxTree, int, int, INT_MIN, MAX_COMBINE, AT_LEAST)
+//
+// generates MaxTree_first(st, L, R, x).
+
+#define DEFINE_SEGMENT_TREE_SEARCH(NAME, T, X, IDENTITY, COMBINE, COND)       \
+                                                                              \
+/* First i in [L, R] with COND(arr[L] + ... + arr[i], x), or -1. */           \
+static inline int NAME##_first(const NAME* st, int L, int R, X x) {           \
+    if (L < 0 || R > st->n - 1 || L > R) {                                    \
+        fprintf(stderr, "Invalid query range\n");                             \
+        return -1;                                                            \
+    }                                                                         \
+    T acc = (IDENTITY);                                                       \
+    int i = L + st->size;                                                     \
+    do {                                                                      \
+        /* Climb to the largest node that starts at position i */             \
+        while (i % 2 == 0) i >>= 1;                                           \
+        T next = COMBINE(acc, st->tree[i]);                                   \
+        if (COND(next, x)) {                                                  \
+            /* The answer is inside node i: descend, skipping left */         \
+            /* children that do not satisfy COND yet */                       \
+            while (i < st->size) {                                            \
+                i = 2 * i;                                                    \
+                T left = COMBINE(acc, st->tree[i]);                           \
+                if (!COND(left, x)) {                                         \
+                    acc = left;                                               \
+                    i++;                                                      \
+                }                                                             \
+            }                                                                 \
+            return i - st->size <= R ? i - st->size : -1;                     \
+        }                                                                     \
+        acc = next;                                                           \
+        i++;                                                                  \
+    } while ((i & -i) != i); /* Stop after the last node of the tree */       \
+    return -1;                                                                \
+}
+
+// -----------------------------------------------------------------
+// 2. Instantiations
+// -----------------------------------------------------------------
+
+#define SUM_COMBINE(a, b) ((a) + (b))
+#define MIN_COMBINE(a, b) ((a) < (b) ? (a) : (b))
+#define MAX_COMBINE(a, b) ((a) > (b) ? (a) : (b))
+#define XOR_COMBINE(a, b) ((a) ^ (b))
+#define AT_LEAST(acc, x) ((acc) >= (x))
+
+static inline long long gcd(long long a, long long b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b != 0) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Smallest value and the index of its first occurrence
+typedef struct {
+    int value;
+    int index;
+} MinArg;
+
+static inline MinArg minArg(MinArg a, MinArg b) {
+    // Ties go to a, the left operand, which holds the lower index
+    return b.value < a.value ? b : a;
+}
+
+#define MINARG_IDENTITY ((MinArg){INT_MAX, -1})
+
+// 2x2 matrix with entries mod MOD, e.g. composed linear recurrences
+#define MOD 1000000007LL
+
+typedef struct {
+    long long a, b, c, d; // [a b; c d]
+} Mat2;
+
+static inline Mat2 matMul(Mat2 x, Mat2 y) {
+    Mat2 r;
+    r.a = (x.a * y.a + x.b * y.c) % MOD;
+    r.b = (x.a * y.b + x.b * y.d) % MOD;
+    r.c = (x.c * y.a + x.d * y.c) % MOD;
+    r.d = (x.c * y.b + x.d * y.d) % MOD;
+    return r;
+}
+
+#define MAT2_IDENTITY ((Mat2){1, 0, 0, 1})
+
+DEFINE_SEGMENT_TREE(SumTree, long long, 0LL, SUM_COMBINE)
+DEFINE_SEGMENT_TREE(MinTree, int, INT_MAX, MIN_COMBINE)
+DEFINE_SEGMENT_TREE(MaxTree, int, INT_MIN, MAX_COMBINE)
+DEFINE_SEGMENT_TREE(GcdTree, long long, 0LL, gcd)
+DEFINE_SEGMENT_TREE(XorTree, unsigned, 0u, XOR_COMBINE)
+DEFINE_SEGMENT_TREE(ArgMinTree, MinArg, MINARG_IDENTITY, minArg)
+DEFINE_SEGMENT_TREE(MatTree, Mat2, MAT2_IDENTITY, matMul)
+
+// First index in [L, R] holding a value >= x / whose prefix sum from L reaches k
+DEFINE_SEGMENT_TREE_SEARCH(MaxTree, int, int, INT_MIN, MAX_COMBINE, AT_LEAST)
+DEFINE_SEGMENT_TREE_SEARCH(SumTree, long long, long long, 0LL, SUM_COMBINE, AT_LEAST)
+
+// The function-pointer baseline, as in red_black_map.c: same template,
+// but every combine is an indirect call through a non-static pointer.
+long long addLongs(long long a, long long b) { return a + b; }
+long long (*sumCombiner)(long long, long long) = addLongs;
+#define FP_SUM(a, b) sumCombiner((a), (b))
+
+DEFINE_SEGMENT_TREE(FpSumTree, long long, 0LL, FP_SUM)
+
+// -----------------------------------------------------------------
+// 3. Benchmark
+// -----------------------------------------------------------------
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Runs the same query / update trace against one long long instantiation
+// and prints ns per operation for each phase.
+#define BENCH_TREE(NAME, label, arr, n, Ls, Rs, ops)                          \
+    do {                                                                      \
+        NAME st = NAME##_create((arr), (n));                                  \
+        double t0 = nowSeconds();                                             \
+        long long check = 0;                                                  \
+        for (int i = 0; i < (ops); i++)                                       \
+            check += NAME##_query(&st, (Ls)[i], (Rs)[i]);                     \
+        double t1 = nowSeconds();                                             \
+        for (int i = 0; i < (ops); i++)                                       \
+            NAME##_update(&st, (Ls)[i], (Rs)[i] % 1000);                      \
+        double t2 = nowSeconds();                                             \
+        printf("%-22s query %6.1f  update %6.1f ns/op  (check %lld)\n",       \
+               label, (t1 - t0) * 1e9 / (ops), (t2 - t1) * 1e9 / (ops), check); \
+        NAME##_free(&st);                                                     \
+    } while (0)
+
+// -----------------------------------------------------------------
+// 4. Main Function (Driver Code)
+// -----------------------------------------------------------------
+
+int main() {
+    int ints[] = {5, 2, 8, 2, 9, 1, 7, 3};
+    int n = sizeof(ints) / sizeof(ints[0]);
+
+    // 1. Sums that overflow int
+    long long big[] = {2000000000LL, 2000000000LL, 2000000000LL, 1};
+    SumTree sums = SumTree_create(big, 4);
+    printf("SumTree [0, 3] = %lld\n", SumTree_query(&sums, 0, 3)); // 6000000001
+    printf("Sum from 1 reaches 4e9 at index %d\n", SumTree_first(&sums, 1, 3, 4000000000LL)); // 2
+    SumTree_free(&sums);
+
+    // 2. Min / max / xor over the same data
+    MinTree mins = MinTree_create(ints, n);
+    MaxTree maxs = MaxTree_create(ints, n);
+    unsigned bits[8];
+    for (int i = 0; i < n; i++) bits[i] = (unsigned)ints[i];
+    XorTree xors = XorTree_create(bits, n);
+    printf("[2, 6]: min %d, max %d, xor %u\n", MinTree_query(&mins, 2, 6),
+           MaxTree_query(&maxs, 2, 6), XorTree_query(&xors, 2, 6));
+    printf("First value >= 8 in [3, 7]: index %d, >= 10: index %d\n",
+           MaxTree_first(&maxs, 3, 7, 8), MaxTree_first(&maxs, 3, 7, 10)); // 4, -1
+    MinTree_free(&mins);
+    MaxTree_free(&maxs);
+    XorTree_free(&xors);
+
+    // 3. gcd
+    long long multiples[] = {12, 18, 30, 42, 7};
+    GcdTree gcds = GcdTree_create(multiples, 5);
+    printf("gcd [0, 3] = %lld, gcd [0, 4] = %lld\n",
+           GcdTree_query(&gcds, 0, 3), GcdTree_query(&gcds, 0, 4));
+    GcdTree_free(&gcds);
+
+    // 4. (min, argmin)
+    MinArg pairs[8];
+    for (int i = 0; i < n; i++) pairs[i] = (MinArg){ints[i], i};
+    ArgMinTree argmins = ArgMinTree_create(pairs, n);
+    MinArg m = ArgMinTree_query(&argmins, 0, 4);
+    printf("argmin [0, 4] = index %d (value %d)\n", m.index, m.value);
+    ArgMinTree_update(&argmins, 3, (MinArg){0, 3});
+    m = ArgMinTree_query(&argmins, 0, 4);
+    printf("after arr[3] = 0: argmin [0, 4] = index %d\n", m.index);
+    ArgMinTree_free(&argmins);
+
+    // 5. Matrix products: F(k) via products of [1 1; 1 0], one per leaf
+    Mat2 steps[90];
+    for (int i = 0; i < 90; i++) steps[i] = (Mat2){1, 1, 1, 0};
+    MatTree mats = MatTree_create(steps, 90);
+    printf("Fibonacci(90) mod 1e9+7 = %lld\n", MatTree_query(&mats, 0, 89).b);
+    MatTree_update(&mats, 0, (Mat2){0, 1, 1, 0}); // Non-commutative: order matters
+    Mat2 p = MatTree_query(&mats, 0, 89);
+    printf("with a swap in front: [%lld %lld; %lld %lld]\n", p.a, p.b, p.c, p.d);
+    MatTree_free(&mats);
+
+    // 6. Inlined combine vs. function-pointer combine
+    printf("\n=====================================\n");
+    int sizes[] = {1000, 100000, 10000000};
+    int ops = 1000000;
+    int* Ls = (int*)malloc(sizeof(int) * ops);
+    int* Rs = (int*)malloc(sizeof(int) * ops);
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        int size = sizes[s];
+        long long* arr = (long long*)malloc(sizeof(long long) * size);
+        srand(42);
+        for (int i = 0; i < size; i++) arr[i] = rand() % 1000;
+        for (int i = 0; i < ops; i++) {
+            int a = rand() % size, b = rand() % size;
+            Ls[i] = a < b ? a : b;
+            Rs[i] = a < b ? b : a;
+        }
+
+        printf("n = %d\n", size);
+        BENCH_TREE(SumTree, "  inlined SUM_COMBINE", arr, size, Ls, Rs, ops);
+        BENCH_TREE(FpSumTree, "  function pointer", arr, size, Ls, Rs, ops);
+        free(arr);
+    }
+    free(Ls);
+    free(Rs);
+
+    return 0;
+}
@@ -0,0 +1,558 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------
+// 1. Type Definitions and Structures
+// -----------------------------------------------------------------
+
+// A persistent (path-copying) variant of red_black.c.
+//
+// insert/deleteNode never modify an existing version: they copy only
+// the nodes on the root-to-target path (plus the few siblings touched
+// by the fixup) and share every other subtree with the old version.
+// Sharing is tracked with a per-node reference count, so a version is
+// just a root pointer and stays valid until it is released.
+//
+// Nodes have no parent pointers (a shared subtree has many parents),
+// so the fixups walk an explicit path stack instead of node->parent.
+// NULL plays the role of the black NIL sentinel.
+
+// Color enumeration
+typedef enum { RED, BLACK } Color;
+
+// Node structure
+typedef struct PNode {
+    int key;
+    Color color;
+    int refcount;       // Number of parents/version handles pointing here
+    struct PNode *left;
+    struct PNode *right;
+} PNode;
+
+// Red-black height is at most 2*log2(n+1), so 128 covers any n that fits in memory
+#define MAX_DEPTH 128
+
+// Running count of live nodes, used to show how much each version shares
+static long liveNodes = 0;
+
+// -----------------------------------------------------------------
+// 2. Function Prototypes
+// -----------------------------------------------------------------
+
+// --- Public Functions ---
+PNode* insert(PNode* root, int key);
+PNode* deleteNode(PNode* root, int key);
+PNode* search(PNode* root, int key);
+PNode* retainVersion(PNode* root);
+void releaseVersion(PNode* root);
+void inorder(PNode* root);
+void printTree(PNode* root);
+
+// --- Internal Helper Functions ---
+PNode* createNode(int key);
+PNode* cloneNode(PNode* node);
+PNode* own(PNode** slot);
+PNode* leftRotate(PNode* x);
+PNode* rightRotate(PNode* y);
+void replaceChild(PNode** root, PNode* parent, PNode* oldChild, PNode* newChild);
+void insertFixup(PNode** root, PNode* path[], int depth);
+void deleteFixup(PNode** root, PNode* path[], int k, PNode* x, int xIsLeft);
+void inorderHelper(PNode* node);
+void printTreeHelper(PNode* root, int space);
+int checkBlackHeight(PNode* node);
+
+
+// -----------------------------------------------------------------
+// 3. Main Function (Driver Code)
+// -----------------------------------------------------------------
+
+int main() {
+    // 1. Build a chain of versions, one per insert
+    int keys_to_insert[] = {10, 20, 30, 15, 25, 5, 1};
+    int num_keys = sizeof(keys_to_insert) / sizeof(keys_to_insert[0]);
+    PNode* versions[16];
+    int num_versions = 0;
+
+    versions[num_versions++] = NULL; // v0: empty tree
+
+    printf("Inserting keys: ");
+    for (int i = 0; i < num_keys; i++) {
+        printf("%d ", keys_to_insert[i]);
+        versions[num_versions] = insert(versions[num_versions - 1], keys_to_insert[i]);
+        num_versions++;
+    }
+    printf("\n\n");
+
+    PNode* latest = versions[num_versions - 1];
+    printTree(latest);
+    inorder(latest);
+    printf("Live nodes across %d versions: %ld\n", num_versions, liveNodes);
+
+    // 2. Delete from the latest version; older versions are untouched
+    printf("\n=====================================\n");
+    int keys_to_delete[] = {1, 30, 10};
+    num_keys = sizeof(keys_to_delete) / sizeof(keys_to_delete[0]);
+
+    for (int i = 0; i < num_keys; i++) {
+        printf("\nDeleting: %d\n", keys_to_delete[i]);
+        versions[num_versions] = deleteNode(versions[num_versions - 1], keys_to_delete[i]);
+        num_versions++;
+        printTree(versions[num_versions - 1]);
+        inorder(versions[num_versions - 1]);
+    }
+
+    // 3. Every historical version is still queryable
+    printf("\n=====================================\n");
+    int key_to_search = 10;
+    for (int v = 0; v < num_versions; v++) {
+        PNode* found = search(versions[v], key_to_search);
+        printf("Version %2d: key %d %s, black height %d\n", v, key_to_search,
+               found != NULL ? "found" : "not found", checkBlackHeight(versions[v]));
+    }
+    printf("Live nodes across %d versions: %ld\n", num_versions, liveNodes);
+
+    // 4. Release every version; shared nodes go away with their last owner
+    for (int v = 0; v < num_versions; v++) {
+        releaseVersion(versions[v]);
+    }
+    printf("\nAll versions released, live nodes: %ld\n", liveNodes);
+
+    return 0;
+}
+
+// -----------------------------------------------------------------
+// 4. Function Implementations
+// -----------------------------------------------------------------
+
+// --- Create / Copy ---
+
+/**
+ * @brief Creates a new RED node with the given key and a single owner.
+ */
+PNode* createNode(int key) {
+    PNode* node = (PNode*)malloc(sizeof(PNode));
+    if (node == NULL) {
+        fprintf(stderr, "Failed to allocate memory for new node\n");
+        exit(EXIT_FAILURE);
+    }
+    node->key = key;
+    node->color = RED; // New nodes are always RED
+    node->refcount = 1;
+    node->left = NULL;
+    node->right = NULL;
+    liveNodes++;
+    return node;
+}
+
+/**
+ * @brief Copies a node. The copy points at the same children,
+ * so both children gain an owner.
+ */
+PNode* cloneNode(PNode* node) {
+    PNode* copy = createNode(node->key);
+    copy->color = node->color;
+    copy->left = node->left;
+    copy->right = node->right;
+    if (copy->left != NULL) copy->left->refcount++;
+    if (copy->right != NULL) copy->right->refcount++;
+    return copy;
+}
+
+/**
+ * @brief Makes the node in *slot private to the version being built.
+ *
+ * The slot always belongs to a node created by the current operation.
+ * Any node reachable from an older version has at least two owners
+ * (the old parent and this one), so a refcount of 1 means the node was
+ * already copied and may be mutated in place.
+ */
+PNode* own(PNode** slot) {
+    PNode* node = *slot;
+    if (node == NULL || node->refcount == 1) {
+        return node;
+    }
+    PNode* copy = cloneNode(node);
+    node->refcount--; // The slot no longer points at the shared node
+    *slot = copy;
+    return copy;
+}
+
+// --- Version handles ---
+
+/**
+ * @brief Takes an extra reference on a version so it can be handed to a reader.
+ */
+PNode* retainVersion(PNode* root) {
+    if (root != NULL) root->refcount++;
+    return root;
+}
+
+/**
+ * @brief Drops a reference on a version, freeing nodes no other version shares.
+ * Reference counts are not atomic: retain/release must be serialized with
+ * the writer, while searches on a held version need no locking at all.
+ */
+void releaseVersion(PNode* root) {
+    if (root == NULL || --root->refcount > 0) return;
+    releaseVersion(root->left);
+    releaseVersion(root->right);
+    free(root);
+    liveNodes--;
+}
+
+// --- Rotations ---
+
+/**
+ * @brief Performs a left rotation on x and returns the new subtree root.
+ * x and x->right must already be private to the current version.
+ */
+PNode* leftRotate(PNode* x) {
+    PNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+/**
+ * @brief Performs a right rotation on y and returns the new subtree root.
+ * y and y->left must already be private to the current version.
+ */
+PNode* rightRotate(PNode* y) {
+    PNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    return x;
+}
+
+/**
+ * @brief Points parent (or the root, if parent is NULL) at newChild instead of oldChild.
+ */
+void replaceChild(PNode** root, PNode* parent, PNode* oldChild, PNode* newChild) {
+    if (parent == NULL) {
+        *root = newChild;
+    } else if (parent->left == oldChild) {
+        parent->left = newChild;
+    } else {
+        parent->right = newChild;
+    }
+}
+
+static Color colorOf(PNode* node) {
+    return node == NULL ? BLACK : node->color;
+}
+
+// --- Insert ---
+
+/**
+ * @brief Returns a new version with key inserted.
+ * The old version is left unchanged and still owned by the caller.
+ */
+PNode* insert(PNode* root, int key) {
+    if (root == NULL) {
+        PNode* node = createNode(key);
+        node->color = BLACK;
+        return node;
+    }
+
+    PNode* path[MAX_DEPTH];
+    int depth = 0;
+
+    // 1. Copy the search path; everything off the path is shared
+    PNode* newRoot = cloneNode(root);
+    path[depth] = newRoot;
+    while (1) {
+        PNode* cur = path[depth];
+        PNode** slot = (key < cur->key) ? &cur->left : &cur->right;
+        if (*slot == NULL) {
+            *slot = createNode(key);
+            path[++depth] = *slot;
+            break;
+        }
+        path[++depth] = own(slot);
+    }
+
+    // 2. Fix Red-Black properties on the private path
+    insertFixup(&newRoot, path, depth);
+    return newRoot;
+}
+
+/**
+ * @brief Restores Red-Black properties after insertion.
+ * path[0..depth] is the copied root-to-z path; path[depth] is z.
+ */
+void insertFixup(PNode** root, PNode* path[], int depth) {
+    int i = depth;
+    while (i >= 2 && path[i - 1]->color == RED) {
+        PNode* z = path[i];
+        PNode* p = path[i - 1];
+        PNode* g = path[i - 2];
+        PNode* gg = (i >= 3) ? path[i - 3] : NULL;
+
+        if (p == g->left) { // Parent is left child
+            // Case 1: Uncle is RED
+            if (colorOf(g->right) == RED) {
+                own(&g->right)->color = BLACK;
+                p->color = BLACK;
+                g->color = RED;
+                i -= 2;
+                continue;
+            }
+            // Case 2: Uncle is BLACK, z is a right child (Triangle)
+            if (z == p->right) {
+                g->left = leftRotate(p);
+                p = z;
+            }
+            // Case 3: Uncle is BLACK, z is a left child (Line)
+            p->color = BLACK;
+            g->color = RED;
+            replaceChild(root, gg, g, rightRotate(g));
+        } else { // Parent is right child (symmetric)
+            // Case 1: Uncle is RED
+            if (colorOf(g->left) == RED) {
+                own(&g->left)->color = BLACK;
+                p->color = BLACK;
+                g->color = RED;
+                i -= 2;
+                continue;
+            }
+            // Case 2: Uncle is BLACK, z is a left child (Triangle)
+            if (z == p->left) {
+                g->right = rightRotate(p);
+                p = z;
+            }
+            // Case 3: Uncle is BLACK, z is a right child (Line)
+            p->color = BLACK;
+            g->color = RED;
+            replaceChild(root, gg, g, leftRotate(g));
+        }
+        break;
+    }
+    // Ensure root is always BLACK (the root is always a fresh copy)
+    (*root)->color = BLACK;
+}
+
+// --- Delete ---
+
+/**
+ * @brief Returns a new version with one occurrence of key removed.
+ * If key is absent, the returned version shares the old root.
+ */
+PNode* deleteNode(PNode* root, int key) {
+    if (search(root, key) == NULL) {
+        printf("Node with key %d not found.\n", key);
+        return retainVersion(root);
+    }
+
+    PNode* path[MAX_DEPTH];
+    int depth = 0;
+
+    // 1. Copy the path down to z
+    PNode* newRoot = cloneNode(root);
+    path[depth] = newRoot;
+    while (path[depth]->key != key) {
+        PNode* cur = path[depth];
+        path[++depth] = own(key < cur->key ? &cur->left : &cur->right);
+    }
+
+    // 2. If z has two children, continue to its successor y and move y's key up
+    PNode* z = path[depth];
+    if (z->left != NULL && z->right != NULL) {
+        path[++depth] = own(&z->right);
+        while (path[depth]->left != NULL) {
+            PNode* cur = path[depth];
+            path[++depth] = own(&cur->left);
+        }
+        z->key = path[depth]->key;
+    }
+
+    // 3. Unlink y (now at most one child); x takes its place
+    PNode* y = path[depth];
+    PNode* x = (y->left != NULL) ? y->left : y->right;
+    PNode* parent = (depth > 0) ? path[depth - 1] : NULL;
+    int xIsLeft = (parent != NULL && parent->left == y);
+    replaceChild(&newRoot, parent, y, x);
+    y->left = y->right = NULL; // x keeps the reference y held
+    Color y_original_color = y->color;
+    releaseVersion(y);
+
+    // 4. Fix Red-Black properties if a BLACK node was removed
+    if (y_original_color == BLACK) {
+        if (colorOf(x) == RED) {
+            own(parent == NULL ? &newRoot : (xIsLeft ? &parent->left : &parent->right))->color = BLACK;
+        } else {
+            deleteFixup(&newRoot, path, depth - 1, x, xIsLeft);
+        }
+    }
+    if (newRoot != NULL) newRoot->color = BLACK;
+    return newRoot;
+}
+
+/**
+ * @brief Restores Red-Black properties after deletion.
+ * x is a doubly-black child of path[k] on the side given by xIsLeft.
+ * Every node on path[0..k] is private; siblings are copied before they change.
+ */
+void deleteFixup(PNode** root, PNode* path[], int k, PNode* x, int xIsLeft) {
+    while (k >= 0 && colorOf(x) == BLACK) {
+        PNode* p = path[k];
+        PNode* pp = (k > 0) ? path[k - 1] : NULL;
+
+        if (xIsLeft) {
+            PNode* w = own(&p->right); // Sibling
+
+            // Case 1: Sibling w is RED
+            if (w->color == RED) {
+                w->color = BLACK;
+                p->color = RED;
+                replaceChild(root, pp, p, leftRotate(p));
+                path[k] = w;        // w is now p's parent
+                path[++k] = p;
+                pp = w;
+                w = own(&p->right);
+            }
+
+            // Case 2: Sibling w is BLACK, both w's children are BLACK
+            if (colorOf(w->left) == BLACK && colorOf(w->right) == BLACK) {
+                w->color = RED;
+                x = p;
+                k--;
+                xIsLeft = (pp != NULL && pp->left == p);
+            } else {
+                // Case 3: Sibling w is BLACK, w.left is RED, w.right is BLACK
+                if (colorOf(w->right) == BLACK) {
+                    own(&w->left)->color = BLACK;
+                    w->color = RED;
+                    w = p->right = rightRotate(w);
+                }
+
+                // Case 4: Sibling w is BLACK, w.right is RED
+                w->color = p->color;
+                p->color = BLACK;
+                own(&w->right)->color = BLACK;
+                replaceChild(root, pp, p, leftRotate(p));
+                return; // Fixup complete
+            }
+        } else { // Symmetric cases: x is a right child
+            PNode* w = own(&p->left); // Sibling
+
+            // Case 1: Sibling w is RED
+            if (w->color == RED) {
+                w->color = BLACK;
+                p->color = RED;
+                replaceChild(root, pp, p, rightRotate(p));
+                path[k] = w;
+                path[++k] = p;
+                pp = w;
+                w = own(&p->left);
+            }
+
+            // Case 2: Sibling w is BLACK, both w's children are BLACK
+            if (colorOf(w->left) == BLACK && colorOf(w->right) == BLACK) {
+                w->color = RED;
+                x = p;
+                k--;
+                xIsLeft = (pp != NULL && pp->left == p);
+            } else {
+                // Case 3: Sibling w is BLACK, w.left is BLACK, w.right is RED
+                if (colorOf(w->left) == BLACK) {
+                    own(&w->right)->color = BLACK;
+                    w->color = RED;
+                    w = p->left = leftRotate(w);
+                }
+
+                // Case 4: Sibling w is BLACK, w.left is RED
+                w->color = p->color;
+                p->color = BLACK;
+                own(&w->left)->color = BLACK;
+                replaceChild(root, pp, p, rightRotate(p));
+                return; // Fixup complete
+            }
+        }
+    }
+    // x is a path node here (or the root), so it is private
+    if (x != NULL) x->color = BLACK;
+}
+
+// --- Search ---
+
+/**
+ * @brief Searches a version for the given key.
+ * Returns the node if found, otherwise NULL. Never modifies the tree.
+ */
+PNode* search(PNode* root, int key) {
+    PNode* current = root;
+    while (current != NULL && key != current->key) {
+        if (key < current->key) {
+            current = current->left;
+        } else {
+            current = current->right;
+        }
+    }
+    return current;
+}
+
+/**
+ * @brief Returns the black height of a version, or -1 if it is not a valid Red-Black tree.
+ */
+int checkBlackHeight(PNode* node) {
+    if (node == NULL) return 1;
+    if (node->color == RED && (colorOf(node->left) == RED || colorOf(node->right) == RED)) {
+        return -1;
+    }
+    int lh = checkBlackHeight(node->left);
+    int rh = checkBlackHeight(node->right);
+    if (lh < 0 || rh < 0 || lh != rh) return -1;
+    return lh + (node->color == BLACK ? 1 : 0);
+}
+
+// --- Print ---
+
+/**
+ * @brief Public function to print a version inorder.
+ */
+void inorder(PNode* root) {
+    printf("Inorder Traversal: ");
+    inorderHelper(root);
+    printf("\n");
+}
+
+/**
+ * @brief Recursive helper for inorder traversal.
+ */
+void inorderHelper(PNode* node) {
+    if (node != NULL) {
+        inorderHelper(node->left);
+        printf("%d(%c) ", node->key, (node->color == RED ? 'R' : 'B'));
+        inorderHelper(node->right);
+    }
+}
+
+#define COUNT 10
+
+/**
+ * @brief Recursive helper to print the tree structure.
+ */
+void printTreeHelper(PNode* root, int space) {
+    if (root == NULL)
+        return;
+
+    space += COUNT;
+
+    printTreeHelper(root->right, space);
+
+    printf("\n");
+    for (int i = COUNT; i < space; i++)
+        printf(" ");
+    printf("%d(%c)\n", root->key, (root->color == RED ? 'R' : 'B'));
+
+    printTreeHelper(root->left, space);
+}
+
+/**
+ * @brief Public function to print a 2D representation of a version.
+ */
+void printTree(PNode* root) {
+    printf("Tree Structure:\n");
+    printTreeHelper(root, 0);
+    printf("\n-------------------------------------\n");
+}
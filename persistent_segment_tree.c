@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Persistent version of segment_tree.c: an update never modifies a node.
+// It copies the O(log n) nodes on the root-to-leaf path, and the copies
+// point at the untouched subtrees of the old version, so every version
+// stays a complete tree and can be queried in O(log n) forever.
+//
+// Nodes live in one pool and name their children by index instead of
+// the implicit 2*node+1 / 2*node+2 layout (versions share subtrees, so
+// there is no single layout). Indices stay valid when the pool grows,
+// and a node is 16 bytes instead of 24 with two pointers.
+
+typedef struct {
+    long long sum;
+    int left;  // Pool index of the left child (-1 for a leaf)
+    int right; // Pool index of the right child (-1 for a leaf)
+} PSTNode;
+
+typedef struct {
+    PSTNode* pool;
+    int poolSize;
+    int poolCap;
+    int* roots;       // roots[v] is the root node of version v
+    int numVersions;
+    int capVersions;
+    int n;            // Size of the original input array
+} PersistentSegmentTree;
+
+/**
+ * @brief Takes a fresh node from the pool, growing it if needed.
+ * @return Index of the new node
+ */
+int newNode(PersistentSegmentTree* pst, long long sum, int left, int right) {
+    if (pst->poolSize == pst->poolCap) {
+        pst->poolCap *= 2;
+        pst->pool = (PSTNode*)realloc(pst->pool, sizeof(PSTNode) * pst->poolCap);
+        if (pst->pool == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    PSTNode* node = &pst->pool[pst->poolSize];
+    node->sum = sum;
+    node->left = left;
+    node->right = right;
+    return pst->poolSize++;
+}
+
+/**
+ * @brief Records root as the next version.
+ * @return The new version number
+ */
+int addVersion(PersistentSegmentTree* pst, int root) {
+    if (pst->numVersions == pst->capVersions) {
+        pst->capVersions *= 2;
+        pst->roots = (int*)realloc(pst->roots, sizeof(int) * pst->capVersions);
+        if (pst->roots == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    pst->roots[pst->numVersions] = root;
+    return pst->numVersions++;
+}
+
+/**
+ * @brief Recursive function to build version 0.
+ * @return Pool index of the subtree root for arr[start..end]
+ */
+int buildPersistent(PersistentSegmentTree* pst, int arr[], int start, int end) {
+    if (start == end) {
+        return newNode(pst, arr[start], -1, -1);
+    }
+    int mid = (start + end) / 2;
+    int left = buildPersistent(pst, arr, start, mid);
+    int right = buildPersistent(pst, arr, mid + 1, end);
+    // Read the sums through the pool only now: building may have moved it
+    return newNode(pst, pst->pool[left].sum + pst->pool[right].sum, left, right);
+}
+
+/**
+ * @brief Builds version 0 over arr.
+ * @param arr The input array
+ * @param n Size of the input array
+ * @return A new PersistentSegmentTree holding one version
+ */
+PersistentSegmentTree createPersistentSegmentTree(int arr[], int n) {
+    PersistentSegmentTree pst;
+    pst.n = n;
+    pst.poolSize = 0;
+    pst.poolCap = 2 * n;  // Exactly the nodes of version 0
+    pst.pool = (PSTNode*)malloc(sizeof(PSTNode) * pst.poolCap);
+    pst.numVersions = 0;
+    pst.capVersions = 16;
+    pst.roots = (int*)malloc(sizeof(int) * pst.capVersions);
+    if (pst.pool == NULL || pst.roots == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    addVersion(&pst, buildPersistent(&pst, arr, 0, n - 1));
+    return pst;
+}
+
+/**
+ * @brief Recursive range sum over one version's subtree.
+ */
+long long queryPersistentRecursive(PersistentSegmentTree* pst, int node, int start, int end, int L, int R) {
+    // No overlap
+    if (start > R || end < L) {
+        return 0;
+    }
+    // Total overlap
+    if (L <= start && end <= R) {
+        return pst->pool[node].sum;
+    }
+    // Partial overlap
+    int mid = (start + end) / 2;
+    return queryPersistentRecursive(pst, pst->pool[node].left, start, mid, L, R) +
+           queryPersistentRecursive(pst, pst->pool[node].right, mid + 1, end, L, R);
+}
+
+/**
+ * @brief Sum of [L, R] as of the given version.
+ */
+long long persistentQuery(PersistentSegmentTree* pst, int version, int L, int R) {
+    if (version < 0 || version >= pst->numVersions) {
+        fprintf(stderr, "Invalid version\n");
+        return -1;
+    }
+    if (L < 0 || R > pst->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    return queryPersistentRecursive(pst, pst->roots[version], 0, pst->n - 1, L, R);
+}
+
+/**
+ * @brief Recursive path copy for a point update.
+ * @return Pool index of the copied subtree root
+ */
+int updatePersistentRecursive(PersistentSegmentTree* pst, int node, int start, int end, int idx, int newValue) {
+    if (start == end) {
+        return newNode(pst, newValue, -1, -1);
+    }
+    int mid = (start + end) / 2;
+    int left = pst->pool[node].left;
+    int right = pst->pool[node].right;
+    if (idx <= mid) {
+        left = updatePersistentRecursive(pst, left, start, mid, idx, newValue);
+    } else {
+        right = updatePersistentRecursive(pst, right, mid + 1, end, idx, newValue);
+    }
+    return newNode(pst, pst->pool[left].sum + pst->pool[right].sum, left, right);
+}
+
+/**
+ * @brief Sets element idx to newValue in a copy of the given version.
+ *        The old version is unchanged.
+ * @return The new version number, or -1 on invalid arguments
+ */
+int persistentUpdate(PersistentSegmentTree* pst, int version, int idx, int newValue) {
+    if (version < 0 || version >= pst->numVersions) {
+        fprintf(stderr, "Invalid version\n");
+        return -1;
+    }
+    if (idx < 0 || idx > pst->n - 1) {
+        fprintf(stderr, "Invalid update index\n");
+        return -1;
+    }
+    int root = updatePersistentRecursive(pst, pst->roots[version], 0, pst->n - 1, idx, newValue);
+    return addVersion(pst, root);
+}
+
+/**
+ * @brief Frees all versions at once.
+ */
+void freePersistentSegmentTree(PersistentSegmentTree* pst) {
+    free(pst->pool);
+    free(pst->roots);
+    pst->pool = NULL;
+    pst->roots = NULL;
+    pst->poolSize = pst->poolCap = 0;
+    pst->numVersions = pst->capVersions = 0;
+    pst->n = 0;
+}
+
+// --- Example Usage ---
+int main() {
+    int arr[] = {1, 3, 5, 7, 9, 11};
+    int n = sizeof(arr) / sizeof(arr[0]);
+
+    PersistentSegmentTree pst = createPersistentSegmentTree(arr, n);
+    int v1 = persistentUpdate(&pst, 0, 2, 6);    // {1, 3, 6, 7, 9, 11}
+    persistentUpdate(&pst, v1, 0, 100);          // Version 2: {100, 3, 6, 7, 9, 11}
+    int v3 = persistentUpdate(&pst, 0, 5, 0);    // Branch off version 0: {1, 3, 5, 7, 9, 0}
+
+    for (int v = 0; v <= v3; v++) {
+        printf("Version %d: sum [0, 2] = %lld, sum [0, 5] = %lld\n", v,
+               persistentQuery(&pst, v, 0, 2), persistentQuery(&pst, v, 0, 5));
+    }
+    printf("Nodes in pool: %d (version 0 alone has %d)\n\n", pst.poolSize, 2 * n - 1);
+    freePersistentSegmentTree(&pst);
+
+    // A long update history, then sums "as of" random versions
+    int size = 1000000, updates = 1000000, queries = 1000000;
+    int* values = (int*)malloc(sizeof(int) * size);
+    srand(42);
+    for (int i = 0; i < size; i++) values[i] = rand() % 1000;
+    pst = createPersistentSegmentTree(values, size);
+
+    clock_t t0 = clock();
+    for (int u = 0; u < updates; u++) {
+        persistentUpdate(&pst, pst.numVersions - 1, rand() % size, rand() % 1000);
+    }
+    clock_t t1 = clock();
+    long long checksum = 0;
+    for (int q = 0; q < queries; q++) {
+        int a = rand() % size, b = rand() % size;
+        checksum += persistentQuery(&pst, rand() % pst.numVersions, a < b ? a : b, a < b ? b : a);
+    }
+    clock_t t2 = clock();
+
+    double poolMB = (double)pst.poolSize * sizeof(PSTNode) / (1 << 20);
+    double copiesMB = (double)updates * size * sizeof(int) / (1 << 20);
+    printf("%d updates on %d elements: %.1f ns/update, historical query %.1f ns (checksum %lld)\n",
+           updates, size, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / updates,
+           (t2 - t1) * 1e9 / CLOCKS_PER_SEC / queries, checksum);
+    printf("Pool: %.0f MB for %d versions; an array copy per version would take %.0f MB\n",
+           poolMB, pst.numVersions, copiesMB);
+
+    freePersistentSegmentTree(&pst);
+    free(values);
+    return 0;
+}
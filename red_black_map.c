@@ -0,0 +1,414 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// -----------------------------------------------------------------
+// 1. Generic Map Template
+// -----------------------------------------------------------------
+
+// A generic key/value red-black map, instantiated per type with a macro
+// (the C version of a template). It is the algorithm from red_black.c
+// (CLRS with a NIL sentinel), but every instantiation gets its own node
+// struct and functions, so:
+//
+//   - the key and value are stored inline in the node, not behind void*;
+//   - CMP is expanded at each call site and inlined by the compiler,
+//     instead of being called through a function pointer.
+//
+// CMP(a, b) must return <0, 0 or >0 like strcmp. Large keys/values should
+// be instantiated with a pointer type so nodes stay small.
+//
+//   DEFINE_RB_MAP(IntMap, int, long, INT_CMP)
+//
+// generates IntMap, IntMapNode and IntMap_create/insert/find/erase/
+// first/next/free.
+
+typedef enum { RED, BLACK } Color;
+
+#define DEFINE_RB_MAP(NAME, K, V, CMP)                                        \
+                                                                              \
+typedef struct NAME##Node {                                                   \
+    K key;                                                                    \
+    V value;                                                                  \
+    Color color;                                                              \
+    struct NAME##Node *parent;                                                \
+    struct NAME##Node *left;                                                  \
+    struct NAME##Node *right;                                                 \
+} NAME##Node;                                                                 \
+                                                                              \
+typedef struct NAME {                                                         \
+    NAME##Node *root;                                                         \
+    NAME##Node *NIL;                                                          \
+    size_t size;                                                              \
+} NAME;                                                                       \
+                                                                              \
+/* Creates an empty map with its own NIL sentinel. */                         \
+static inline NAME* NAME##_create(void) {                                     \
+    NAME* map = (NAME*)malloc(sizeof(NAME));                                  \
+    NAME##Node* nil = (NAME##Node*)calloc(1, sizeof(NAME##Node));             \
+    if (map == NULL || nil == NULL) {                                         \
+        fprintf(stderr, "Failed to allocate memory for map\n");               \
+        exit(EXIT_FAILURE);                                                   \
+    }                                                                         \
+    nil->color = BLACK;                                                       \
+    map->NIL = nil;                                                           \
+    map->root = nil;                                                          \
+    map->size = 0;                                                            \
+    return map;                                                               \
+}                                                                             \
+                                                                              \
+static inline void NAME##_leftRotate(NAME* map, NAME##Node* x) {              \
+    NAME##Node* y = x->right;                                                 \
+    x->right = y->left;                                                       \
+    if (y->left != map->NIL) y->left->parent = x;                             \
+    y->parent = x->parent;                                                    \
+    if (x->parent == map->NIL) map->root = y;                                 \
+    else if (x == x->parent->left) x->parent->left = y;                       \
+    else x->parent->right = y;                                                \
+    y->left = x;                                                              \
+    x->parent = y;                                                            \
+}                                                                             \
+                                                                              \
+static inline void NAME##_rightRotate(NAME* map, NAME##Node* y) {             \
+    NAME##Node* x = y->left;                                                  \
+    y->left = x->right;                                                       \
+    if (x->right != map->NIL) x->right->parent = y;                           \
+    x->parent = y->parent;                                                    \
+    if (y->parent == map->NIL) map->root = x;                                 \
+    else if (y == y->parent->right) y->parent->right = x;                     \
+    else y->parent->left = x;                                                 \
+    x->right = y;                                                             \
+    y->parent = x;                                                            \
+}                                                                             \
+                                                                              \
+/* Returns the node holding key, or NULL. */                                  \
+static inline NAME##Node* NAME##_findNode(NAME* map, K key) {                 \
+    NAME##Node* current = map->root;                                          \
+    while (current != map->NIL) {                                             \
+        int c = CMP(key, current->key);                                       \
+        if (c == 0) return current;                                           \
+        current = (c < 0) ? current->left : current->right;                   \
+    }                                                                         \
+    return NULL;                                                              \
+}                                                                             \
+                                                                              \
+/* Returns a pointer to the value stored for key, or NULL. */                 \
+static inline V* NAME##_find(NAME* map, K key) {                              \
+    NAME##Node* node = NAME##_findNode(map, key);                             \
+    return node ? &node->value : NULL;                                        \
+}                                                                             \
+                                                                              \
+static inline void NAME##_insertFixup(NAME* map, NAME##Node* z) {             \
+    while (z->parent->color == RED) {                                         \
+        NAME##Node* g = z->parent->parent;                                    \
+        if (z->parent == g->left) {                                           \
+            NAME##Node* y = g->right;                                         \
+            if (y->color == RED) {                                            \
+                z->parent->color = BLACK;                                     \
+                y->color = BLACK;                                             \
+                g->color = RED;                                               \
+                z = g;                                                        \
+            } else {                                                          \
+                if (z == z->parent->right) {                                  \
+                    z = z->parent;                                            \
+                    NAME##_leftRotate(map, z);                                \
+                }                                                             \
+                z->parent->color = BLACK;                                     \
+                z->parent->parent->color = RED;                               \
+                NAME##_rightRotate(map, z->parent->parent);                   \
+            }                                                                 \
+        } else {                                                              \
+            NAME##Node* y = g->left;                                          \
+            if (y->color == RED) {                                            \
+                z->parent->color = BLACK;                                     \
+                y->color = BLACK;                                             \
+                g->color = RED;                                               \
+                z = g;                                                        \
+            } else {                                                          \
+                if (z == z->parent->left) {                                   \
+                    z = z->parent;                                            \
+                    NAME##_rightRotate(map, z);                               \
+                }                                                             \
+                z->parent->color = BLACK;                                     \
+                z->parent->parent->color = RED;                               \
+                NAME##_leftRotate(map, z->parent->parent);                    \
+            }                                                                 \
+        }                                                                     \
+    }                                                                         \
+    map->root->color = BLACK;                                                 \
+}                                                                             \
+                                                                              \
+/* Inserts key -> value, overwriting the value if key is present. */          \
+static inline void NAME##_insert(NAME* map, K key, V value) {                 \
+    NAME##Node* y = map->NIL;                                                 \
+    NAME##Node* x = map->root;                                                \
+    int c = 0;                                                                \
+    while (x != map->NIL) {                                                   \
+        y = x;                                                                \
+        c = CMP(key, x->key);                                                 \
+        if (c == 0) {                                                         \
+            x->value = value;                                                 \
+            return;                                                           \
+        }                                                                     \
+        x = (c < 0) ? x->left : x->right;                                     \
+    }                                                                         \
+    NAME##Node* z = (NAME##Node*)malloc(sizeof(NAME##Node));                  \
+    if (z == NULL) {                                                          \
+        fprintf(stderr, "Failed to allocate memory for new node\n");          \
+        exit(EXIT_FAILURE);                                                   \
+    }                                                                         \
+    z->key = key;                                                             \
+    z->value = value;                                                         \
+    z->color = RED;                                                           \
+    z->parent = y;                                                            \
+    z->left = map->NIL;                                                       \
+    z->right = map->NIL;                                                      \
+    if (y == map->NIL) map->root = z;                                         \
+    else if (c < 0) y->left = z;                                              \
+    else y->right = z;                                                        \
+    map->size++;                                                              \
+    NAME##_insertFixup(map, z);                                               \
+}                                                                             \
+                                                                              \
+static inline void NAME##_transplant(NAME* map, NAME##Node* u, NAME##Node* v) { \
+    if (u->parent == map->NIL) map->root = v;                                 \
+    else if (u == u->parent->left) u->parent->left = v;                       \
+    else u->parent->right = v;                                                \
+    v->parent = u->parent;                                                    \
+}                                                                             \
+                                                                              \
+/* Leftmost node of a subtree, or NULL for an empty subtree. */               \
+static inline NAME##Node* NAME##_minimum(NAME* map, NAME##Node* node) {       \
+    if (node == map->NIL) return NULL;                                        \
+    while (node->left != map->NIL) node = node->left;                         \
+    return node;                                                              \
+}                                                                             \
+                                                                              \
+static inline void NAME##_deleteFixup(NAME* map, NAME##Node* x) {             \
+    while (x != map->root && x->color == BLACK) {                             \
+        if (x == x->parent->left) {                                           \
+            NAME##Node* w = x->parent->right;                                 \
+            if (w->color == RED) {                                            \
+                w->color = BLACK;                                             \
+                x->parent->color = RED;                                       \
+                NAME##_leftRotate(map, x->parent);                            \
+                w = x->parent->right;                                         \
+            }                                                                 \
+            if (w->left->color == BLACK && w->right->color == BLACK) {        \
+                w->color = RED;                                               \
+                x = x->parent;                                                \
+            } else {                                                          \
+                if (w->right->color == BLACK) {                               \
+                    w->left->color = BLACK;                                   \
+                    w->color = RED;                                           \
+                    NAME##_rightRotate(map, w);                               \
+                    w = x->parent->right;                                     \
+                }                                                             \
+                w->color = x->parent->color;                                  \
+                x->parent->color = BLACK;                                     \
+                w->right->color = BLACK;                                      \
+                NAME##_leftRotate(map, x->parent);                            \
+                x = map->root;                                                \
+            }                                                                 \
+        } else {                                                              \
+            NAME##Node* w = x->parent->left;                                  \
+            if (w->color == RED) {                                            \
+                w->color = BLACK;                                             \
+                x->parent->color = RED;                                       \
+                NAME##_rightRotate(map, x->parent);                           \
+                w = x->parent->left;                                          \
+            }                                                                 \
+            if (w->left->color == BLACK && w->right->color == BLACK) {        \
+                w->color = RED;                                               \
+                x = x->parent;                                                \
+            } else {                                                          \
+                if (w->left->color == BLACK) {                                \
+                    w->right->color = BLACK;                                  \
+                    w->color = RED;                                           \
+                    NAME##_leftRotate(map, w);                                \
+                    w = x->parent->left;                                      \
+                }                                                             \
+                w->color = x->parent->color;                                  \
+                x->parent->color = BLACK;                                     \
+                w->left->color = BLACK;                                       \
+                NAME##_rightRotate(map, x->parent);                           \
+                x = map->root;                                                \
+            }                                                                 \
+        }                                                                     \
+    }                                                                         \
+    x->color = BLACK;                                                         \
+}                                                                             \
+                                                                              \
+/* Removes key. Returns 1 if it was present, 0 otherwise. */                  \
+static inline int NAME##_erase(NAME* map, K key) {                            \
+    NAME##Node* z = NAME##_findNode(map, key);                                \
+    if (z == NULL) return 0;                                                  \
+    NAME##Node* y = z;                                                        \
+    NAME##Node* x;                                                            \
+    Color y_original_color = y->color;                                        \
+    if (z->left == map->NIL) {                                                \
+        x = z->right;                                                         \
+        NAME##_transplant(map, z, z->right);                                  \
+    } else if (z->right == map->NIL) {                                        \
+        x = z->left;                                                          \
+        NAME##_transplant(map, z, z->left);                                   \
+    } else {                                                                  \
+        y = NAME##_minimum(map, z->right);                                    \
+        y_original_color = y->color;                                          \
+        x = y->right;                                                         \
+        if (y->parent == z) {                                                 \
+            x->parent = y;                                                    \
+        } else {                                                              \
+            NAME##_transplant(map, y, y->right);                              \
+            y->right = z->right;                                              \
+            y->right->parent = y;                                             \
+        }                                                                     \
+        NAME##_transplant(map, z, y);                                         \
+        y->left = z->left;                                                    \
+        y->left->parent = y;                                                  \
+        y->color = z->color;                                                  \
+    }                                                                         \
+    free(z);                                                                  \
+    map->size--;                                                              \
+    if (y_original_color == BLACK) NAME##_deleteFixup(map, x);                \
+    return 1;                                                                 \
+}                                                                             \
+                                                                              \
+/* In-order iteration: first() then next() until NULL. */                     \
+static inline NAME##Node* NAME##_first(NAME* map) {                           \
+    return NAME##_minimum(map, map->root);                                    \
+}                                                                             \
+                                                                              \
+static inline NAME##Node* NAME##_next(NAME* map, NAME##Node* node) {          \
+    if (node->right != map->NIL) return NAME##_minimum(map, node->right);     \
+    NAME##Node* p = node->parent;                                             \
+    while (p != map->NIL && node == p->right) {                               \
+        node = p;                                                             \
+        p = p->parent;                                                        \
+    }                                                                         \
+    return p == map->NIL ? NULL : p;                                          \
+}                                                                             \
+                                                                              \
+static inline void NAME##_freeHelper(NAME* map, NAME##Node* node) {           \
+    if (node != map->NIL) {                                                   \
+        NAME##_freeHelper(map, node->left);                                   \
+        NAME##_freeHelper(map, node->right);                                  \
+        free(node);                                                           \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+/* Frees every node, the sentinel and the map itself. */                      \
+static inline void NAME##_free(NAME* map) {                                   \
+    if (map == NULL) return;                                                  \
+    NAME##_freeHelper(map, map->root);                                        \
+    free(map->NIL);                                                           \
+    free(map);                                                                \
+}
+
+// -----------------------------------------------------------------
+// 2. Instantiations
+// -----------------------------------------------------------------
+
+#define INT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+#define STR_CMP(a, b) strcmp((a), (b))
+
+// A small value type, stored inline in each node
+typedef struct {
+    double x, y;
+} Point;
+
+DEFINE_RB_MAP(IntMap, int, long, INT_CMP)
+DEFINE_RB_MAP(StrMap, const char*, Point, STR_CMP)
+
+// The function-pointer baseline: same template, but every comparison goes
+// through an indirect call, like a void*-based map with a qsort-style cmp.
+// The pointer is not static so the compiler cannot devirtualize it.
+int compareInts(int a, int b) { return INT_CMP(a, b); }
+int (*intComparator)(int, int) = compareInts;
+#define FP_CMP(a, b) intComparator((a), (b))
+
+DEFINE_RB_MAP(FpIntMap, int, long, FP_CMP)
+
+// -----------------------------------------------------------------
+// 3. Benchmark
+// -----------------------------------------------------------------
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Runs the same insert / find / erase trace against one instantiation and
+// prints ns per operation for each phase.
+#define BENCH_MAP(NAME, label, keys, n)                                       \
+    do {                                                                      \
+        NAME* m = NAME##_create();                                            \
+        double t0 = nowSeconds();                                             \
+        for (int i = 0; i < (n); i++) NAME##_insert(m, (keys)[i], i);         \
+        double t1 = nowSeconds();                                             \
+        long sum = 0;                                                         \
+        for (int i = 0; i < (n); i++) {                                       \
+            long* v = NAME##_find(m, (keys)[((size_t)i * 7919) % (n)]);       \
+            if (v) sum += *v;                                                 \
+        }                                                                     \
+        double t2 = nowSeconds();                                             \
+        for (int i = 0; i < (n); i += 2) NAME##_erase(m, (keys)[i]);          \
+        double t3 = nowSeconds();                                             \
+        printf("%-22s insert %6.1f  find %6.1f  erase %6.1f ns/op  (check %ld)\n", \
+               label, (t1 - t0) * 1e9 / (n), (t2 - t1) * 1e9 / (n),           \
+               (t3 - t2) * 1e9 / ((n) / 2), sum);                             \
+        NAME##_free(m);                                                       \
+    } while (0)
+
+// -----------------------------------------------------------------
+// 4. Main Function (Driver Code)
+// -----------------------------------------------------------------
+
+int main() {
+    // 1. int -> long
+    IntMap* ints = IntMap_create();
+    int keys_to_insert[] = {10, 20, 30, 15, 25, 5, 1};
+    int num_keys = sizeof(keys_to_insert) / sizeof(keys_to_insert[0]);
+    for (int i = 0; i < num_keys; i++) {
+        IntMap_insert(ints, keys_to_insert[i], keys_to_insert[i] * 100L);
+    }
+    IntMap_erase(ints, 30);
+    IntMap_insert(ints, 15, -1); // Overwrites
+
+    printf("IntMap (%zu entries): ", ints->size);
+    for (IntMapNode* it = IntMap_first(ints); it != NULL; it = IntMap_next(ints, it)) {
+        printf("%d=%ld ", it->key, it->value);
+    }
+    printf("\n");
+    IntMap_free(ints);
+
+    // 2. string -> struct, value stored inline
+    StrMap* cities = StrMap_create();
+    StrMap_insert(cities, "paris", (Point){48.85, 2.35});
+    StrMap_insert(cities, "tokyo", (Point){35.68, 139.69});
+    StrMap_insert(cities, "lima", (Point){-12.05, -77.04});
+    Point* p = StrMap_find(cities, "tokyo");
+    printf("StrMap: tokyo -> (%.2f, %.2f), node size %zu bytes\n",
+           p->x, p->y, sizeof(StrMapNode));
+    StrMap_free(cities);
+
+    // 3. Inlined comparator vs. function-pointer comparator
+    printf("\n=====================================\n");
+    int sizes[] = {1000, 100000, 1000000};
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        int n = sizes[s];
+        int* keys = (int*)malloc(sizeof(int) * n);
+        srand(42);
+        for (int i = 0; i < n; i++) keys[i] = rand();
+
+        printf("n = %d\n", n);
+        BENCH_MAP(IntMap, "  inlined INT_CMP", keys, n);
+        BENCH_MAP(FpIntMap, "  function pointer", keys, n);
+        free(keys);
+    }
+
+    return 0;
+}
@@ -1,12 +1,28 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> // For memset
+#include <time.h>
+#include <unistd.h> // For sysconf
+#include <stdint.h> // For intptr_t
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Pending range update for a node's children: first set every element
+// to 'assign' (if hasAssign), then add 'add'. The node's own sum in
+// 'tree' already includes it.
+typedef struct {
+    int add;
+    int assign;
+    int hasAssign;
+} LazyTag;
 
 // Structure for the Segment Tree
 // We can also just use a simple int* array,
 // but a struct is cleaner.
 typedef struct {
     int* tree; // Pointer to the array storing the tree nodes
+    LazyTag* lazy; // Pending range updates, same indexing as tree
     int n;      // Size of the original input array
 } SegmentTree;
 
@@ -57,11 +73,56 @@ SegmentTree createSegmentTree(int arr[], int n) {
     // Initialize tree with 0 (optional, but good practice)
     memset(st.tree, 0, sizeof(int) * 4 * n);
 
+    // No pending range updates
+    st.lazy = (LazyTag*)calloc(4 * n, sizeof(LazyTag));
+    if (st.lazy == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
     // Build the tree
     buildRecursive(&st, arr, 0, 0, n - 1);
     return st;
 }
 
+/**
+ * @brief Applies a range update to a whole node.
+ * @param st Pointer to the SegmentTree
+ * @param node Index of the node
+ * @param length Number of elements in the node's segment
+ * @param tag The update: assign first (if set), then add
+ */
+void applyTag(SegmentTree* st, int node, int length, LazyTag tag) {
+    LazyTag* lazy = &st->lazy[node];
+    if (tag.hasAssign) {
+        // An assignment overrides everything pending below this node
+        st->tree[node] = tag.assign * length;
+        lazy->assign = tag.assign;
+        lazy->hasAssign = 1;
+        lazy->add = 0;
+    }
+    st->tree[node] += tag.add * length;
+    lazy->add += tag.add;
+}
+
+/**
+ * @brief Hands a node's pending update to its children.
+ * @param st Pointer to the SegmentTree
+ * @param node Index of the node (must not be a leaf)
+ * @param start Start index of the node's segment
+ * @param end End index of the node's segment
+ */
+void pushDown(SegmentTree* st, int node, int start, int end) {
+    LazyTag tag = st->lazy[node];
+    if (!tag.hasAssign && tag.add == 0) {
+        return;
+    }
+    int mid = (start + end) / 2;
+    applyTag(st, 2 * node + 1, mid - start + 1, tag);
+    applyTag(st, 2 * node + 2, end - mid, tag);
+    st->lazy[node] = (LazyTag){0, 0, 0};
+}
+
 /**
  * @brief Recursive function for range sum query.
  * @param st Pointer to the SegmentTree
@@ -87,6 +148,7 @@ int queryRecursive(SegmentTree* st, int node, int start, int end, int L, int R)
 
     // Case 3: Partial overlap
     // Recursively query left and right children
+    pushDown(st, node, start, end);
     int mid = (start + end) / 2;
     int leftChild = 2 * node + 1;
     int rightChild = 2 * node + 2;
@@ -122,6 +184,7 @@ void updateRecursive(SegmentTree* st, int node, int start, int end, int idx, int
         // Leaf node: update the value
         st->tree[node] = newValue;
     } else {
+        pushDown(st, node, start, end);
         int mid = (start + end) / 2;
         int leftChild = 2 * node + 1;
         int rightChild = 2 * node + 2;
@@ -150,16 +213,631 @@ void update(SegmentTree* st, int idx, int newValue) {
     updateRecursive(st, 0, 0, st->n - 1, idx, newValue);
 }
 
+/**
+ * @brief Recursive function for range updates.
+ * @param st Pointer to the SegmentTree
+ * @param node Index of the current node
+ * @param start Start index of the current node's segment
+ * @param end End index of the current node's segment
+ * @param L Left boundary of the update range
+ * @param R Right boundary of the update range
+ * @param tag The update to apply to every element of [L, R]
+ */
+void rangeUpdateRecursive(SegmentTree* st, int node, int start, int end, int L, int R, LazyTag tag) {
+    // No overlap
+    if (start > R || end < L) {
+        return;
+    }
+
+    // Total overlap: tag this node and stop
+    if (L <= start && end <= R) {
+        applyTag(st, node, end - start + 1, tag);
+        return;
+    }
+
+    // Partial overlap
+    pushDown(st, node, start, end);
+    int mid = (start + end) / 2;
+    int leftChild = 2 * node + 1;
+    int rightChild = 2 * node + 2;
+    rangeUpdateRecursive(st, leftChild, start, mid, L, R, tag);
+    rangeUpdateRecursive(st, rightChild, mid + 1, end, L, R, tag);
+    st->tree[node] = st->tree[leftChild] + st->tree[rightChild];
+}
+
+/**
+ * @brief Adds delta to every element in [L, R] in O(log n).
+ */
+void range_add(SegmentTree* st, int L, int R, int delta) {
+    if (L < 0 || R > st->n - 1 || L > R) {
+        fprintf(stderr, "Invalid update range\n");
+        return;
+    }
+    rangeUpdateRecursive(st, 0, 0, st->n - 1, L, R, (LazyTag){delta, 0, 0});
+}
+
+/**
+ * @brief Sets every element in [L, R] to v in O(log n).
+ */
+void range_assign(SegmentTree* st, int L, int R, int v) {
+    if (L < 0 || R > st->n - 1 || L > R) {
+        fprintf(stderr, "Invalid update range\n");
+        return;
+    }
+    rangeUpdateRecursive(st, 0, 0, st->n - 1, L, R, (LazyTag){0, v, 1});
+}
+
+/**
+ * @brief Smallest index i with sum of [0, i] >= k, found in one descent
+ *        from the root: go left if the left child's sum reaches k,
+ *        otherwise subtract it and go right. O(log n), versus O(log^2 n)
+ *        for a binary search over query(). Elements must be non-negative.
+ * @param st Pointer to the SegmentTree
+ * @param k The prefix sum to reach
+ * @return The index, or -1 if the whole array sums to less than k
+ */
+int prefixLowerBound(SegmentTree* st, int k) {
+    if (st->n == 0 || st->tree[0] < k) {
+        return -1;
+    }
+    int node = 0, start = 0, end = st->n - 1;
+    while (start != end) {
+        pushDown(st, node, start, end);
+        int mid = (start + end) / 2;
+        int leftChild = 2 * node + 1;
+        if (st->tree[leftChild] >= k) {
+            node = leftChild;
+            end = mid;
+        } else {
+            k -= st->tree[leftChild];
+            node = leftChild + 1;
+            start = mid + 1;
+        }
+    }
+    return start;
+}
+
 /**
  * @brief Frees all allocated memory for the Segment Tree.
  */
 void freeSegmentTree(SegmentTree* st) {
     free(st->tree);
+    free(st->lazy);
     st->tree = NULL;
+    st->lazy = NULL;
     st->n = 0;
 }
 
+// --- Iterative Segment Tree ---
+
+// Bottom-up segment tree with 2n nodes: the leaves are tree[n, 2n) and
+// node i (1 <= i < n) holds tree[2i] + tree[2i + 1]. Update and query are
+// plain loops over indices, with no recursion and no 4n padding. This
+// layout needs a commutative operation when n is not a power of two,
+// which sum is.
+typedef struct {
+    int* tree;
+    int n;
+} IterSegmentTree;
+
+/**
+ * @brief Builds the iterative tree in O(n).
+ * @param arr The input array
+ * @param n Size of the input array
+ * @return A new, initialized IterSegmentTree
+ */
+IterSegmentTree createIterSegmentTree(int arr[], int n) {
+    IterSegmentTree st;
+    st.n = n;
+    st.tree = (int*)malloc(sizeof(int) * 2 * n);
+    if (st.tree == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    memcpy(st.tree + n, arr, sizeof(int) * n);
+    for (int i = n - 1; i > 0; i--) {
+        st.tree[i] = st.tree[2 * i] + st.tree[2 * i + 1];
+    }
+    return st;
+}
+
+/**
+ * @brief Range sum over [L, R]: walks up from both ends, adding the
+ *        nodes that hang just inside the range.
+ */
+int iterQuery(IterSegmentTree* st, int L, int R) {
+    if (L < 0 || R > st->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    int sum = 0;
+    for (L += st->n, R += st->n + 1; L < R; L >>= 1, R >>= 1) {
+        if (L & 1) sum += st->tree[L++];
+        if (R & 1) sum += st->tree[--R];
+    }
+    return sum;
+}
+
+/**
+ * @brief Sets element idx to newValue and refreshes its ancestors.
+ */
+void iterUpdate(IterSegmentTree* st, int idx, int newValue) {
+    if (idx < 0 || idx > st->n - 1) {
+        fprintf(stderr, "Invalid update index\n");
+        return;
+    }
+    int i = idx + st->n;
+    st->tree[i] = newValue;
+    for (i >>= 1; i > 0; i >>= 1) {
+        st->tree[i] = st->tree[2 * i] + st->tree[2 * i + 1];
+    }
+}
+
+/**
+ * @brief Frees all allocated memory for the iterative tree.
+ */
+void freeIterSegmentTree(IterSegmentTree* st) {
+    free(st->tree);
+    st->tree = NULL;
+    st->n = 0;
+}
+
+/**
+ * @brief Times build, query and update for both trees on the same trace.
+ *        Sizes that do not fit in half of physical memory are skipped.
+ * @param n Number of elements
+ * @param ops Number of queries (and of updates)
+ */
+void benchmarkIterative(int n, int ops) {
+    long long budget = (long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE) / 2;
+    long long recursiveBytes = (long long)n * (4 * (sizeof(int) + sizeof(LazyTag)) + sizeof(int));
+    long long iterBytes = (long long)n * 3 * sizeof(int);
+    if (iterBytes > budget) {
+        printf("%10d  skipped (needs %lld MB)\n", n, iterBytes >> 20);
+        return;
+    }
+    int runRecursive = recursiveBytes <= budget;
+
+    int* arr = (int*)malloc(sizeof(int) * n);
+    int* Ls = (int*)malloc(sizeof(int) * ops);
+    int* Rs = (int*)malloc(sizeof(int) * ops);
+    for (int i = 0; i < n; i++) arr[i] = rand() % 10; // Keeps 10^8-element sums inside int
+    for (int i = 0; i < ops; i++) {
+        int a = rand() % n, b = rand() % n;
+        Ls[i] = a < b ? a : b;
+        Rs[i] = a < b ? b : a;
+    }
+
+    double ns = 1e9 / CLOCKS_PER_SEC;
+    long long sumIter = 0, sumRec = 0;
+    clock_t t0 = clock();
+    IterSegmentTree it = createIterSegmentTree(arr, n);
+    clock_t t1 = clock();
+    for (int i = 0; i < ops; i++) sumIter += iterQuery(&it, Ls[i], Rs[i]);
+    clock_t t2 = clock();
+    for (int i = 0; i < ops; i++) iterUpdate(&it, Ls[i], Rs[i] % 10);
+    clock_t t3 = clock();
+    freeIterSegmentTree(&it);
+    printf("%10d  iterative: build %7.2f ns/elem, query %7.1f ns, update %7.1f ns",
+           n, (t1 - t0) * ns / n, (t2 - t1) * ns / ops, (t3 - t2) * ns / ops);
+
+    if (runRecursive) {
+        t0 = clock();
+        SegmentTree rec = createSegmentTree(arr, n);
+        t1 = clock();
+        for (int i = 0; i < ops; i++) sumRec += query(&rec, Ls[i], Rs[i]);
+        t2 = clock();
+        for (int i = 0; i < ops; i++) update(&rec, Ls[i], Rs[i] % 10);
+        t3 = clock();
+        freeSegmentTree(&rec);
+        printf(" | recursive: build %7.2f ns/elem, query %7.1f ns, update %7.1f ns%s\n",
+               (t1 - t0) * ns / n, (t2 - t1) * ns / ops, (t3 - t2) * ns / ops,
+               sumRec == sumIter ? "" : " (MISMATCH)");
+    } else {
+        printf(" | recursive: skipped (needs %lld MB)\n", recursiveBytes >> 20);
+    }
+
+    free(arr);
+    free(Ls);
+    free(Rs);
+}
+
+// --- Parallel Build and Batch Queries ---
+
+// A small pool of worker threads, created on first use and reused by
+// every parallel call. A job is "run task(arg, i) for i in [0, numTasks)";
+// the caller works on the job too and returns once every task is done.
+// The pool runs one job at a time: concurrent callers queue on jobLock,
+// and a task must not start a parallel call of its own.
+typedef struct {
+    pthread_mutex_t jobLock;   // Held by the caller for a whole job
+    pthread_mutex_t lock;
+    pthread_cond_t start;      // A new job was posted
+    pthread_cond_t done;       // The last worker left the job
+    pthread_t* workers;
+    int numWorkers;
+    unsigned long generation;  // Bumped for every job (and for shutdown)
+    int shutdown;
+    void (*task)(void* arg, int index);
+    void* arg;
+    int numTasks;
+    int participants;          // Workers [0, participants) take this job
+    atomic_int nextTask;       // Next task index to hand out
+    int busy;                  // Workers still inside the current job
+} ThreadPool;
+
+static ThreadPool pool = {
+    .jobLock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .start = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+/**
+ * @brief Runs tasks of the current job until none are left.
+ */
+static void runTasks(void (*task)(void*, int), void* arg, int numTasks) {
+    int i;
+    while ((i = atomic_fetch_add(&pool.nextTask, 1)) < numTasks) {
+        task(arg, i);
+    }
+}
+
+static void* poolWorker(void* arg) {
+    int index = (int)(intptr_t)arg;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    while (1) {
+        while (pool.generation == seen) {
+            pthread_cond_wait(&pool.start, &pool.lock);
+        }
+        seen = pool.generation;
+        if (pool.shutdown) {
+            break;
+        }
+        if (index >= pool.participants) {
+            continue; // The job asked for fewer threads
+        }
+        void (*task)(void*, int) = pool.task;
+        void* arg = pool.arg;
+        int numTasks = pool.numTasks;
+        pthread_mutex_unlock(&pool.lock);
+
+        runTasks(task, arg, numTasks);
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.busy == 0) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+/**
+ * @brief Runs task(arg, i) for every i in [0, numTasks) on up to
+ *        'threads' threads (the caller included) and waits for all of them.
+ */
+void parallelFor(void (*task)(void*, int), void* arg, int numTasks, int threads) {
+    if (threads <= 1 || numTasks <= 1) {
+        for (int i = 0; i < numTasks; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool.jobLock);
+    pthread_mutex_lock(&pool.lock);
+    if (pool.numWorkers < threads - 1) {
+        pthread_t* workers = (pthread_t*)realloc(pool.workers, sizeof(pthread_t) * (threads - 1));
+        if (workers == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+        pool.workers = workers;
+        // If a thread cannot be created, run with the ones we have
+        while (pool.numWorkers < threads - 1 &&
+               pthread_create(&pool.workers[pool.numWorkers], NULL, poolWorker,
+                              (void*)(intptr_t)pool.numWorkers) == 0) {
+            pool.numWorkers++;
+        }
+    }
+    pool.task = task;
+    pool.arg = arg;
+    pool.numTasks = numTasks;
+    pool.participants = pool.numWorkers < threads - 1 ? pool.numWorkers : threads - 1;
+    atomic_store(&pool.nextTask, 0);
+    pool.busy = pool.participants;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    runTasks(task, arg, numTasks);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.busy > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.jobLock);
+}
+
+/**
+ * @brief Stops and joins the pool's workers.
+ */
+void freeThreadPool() {
+    pthread_mutex_lock(&pool.jobLock);
+    pthread_mutex_lock(&pool.lock);
+    pool.shutdown = 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+    for (int i = 0; i < pool.numWorkers; i++) {
+        pthread_join(pool.workers[i], NULL);
+    }
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.numWorkers = 0;
+    pool.shutdown = 0;
+    pthread_mutex_unlock(&pool.jobLock);
+}
+
+// One subtree of the parallel build
+typedef struct {
+    SegmentTree* st;
+    int* arr;
+    int* nodes;   // Root node of each subtree
+    int* starts;  // Segment of each subtree
+    int* ends;
+} BuildJob;
+
+static void buildSubtreeTask(void* arg, int i) {
+    BuildJob* job = (BuildJob*)arg;
+    buildRecursive(job->st, job->arr, job->nodes[i], job->starts[i], job->ends[i]);
+}
+
+/**
+ * @brief Recursive function to build the levels above the subtrees that
+ *        buildSubtreeTask already filled in.
+ */
+static void buildTop(SegmentTree* st, int node, int start, int end, int depth) {
+    if (depth == 0 || start == end) {
+        return;
+    }
+    int mid = (start + end) / 2;
+    buildTop(st, 2 * node + 1, start, mid, depth - 1);
+    buildTop(st, 2 * node + 2, mid + 1, end, depth - 1);
+    st->tree[node] = st->tree[2 * node + 1] + st->tree[2 * node + 2];
+}
+
+/**
+ * @brief Collects the nodes 'depth' levels below node (or the leaves
+ *        above that depth) as independent subtrees for the build.
+ */
+static void collectSubtrees(BuildJob* job, int* count, int node, int start, int end, int depth) {
+    if (depth == 0 || start == end) {
+        job->nodes[*count] = node;
+        job->starts[*count] = start;
+        job->ends[*count] = end;
+        (*count)++;
+        return;
+    }
+    int mid = (start + end) / 2;
+    collectSubtrees(job, count, 2 * node + 1, start, mid, depth - 1);
+    collectSubtrees(job, count, 2 * node + 2, mid + 1, end, depth - 1);
+}
+
+/**
+ * @brief createSegmentTree on several threads. The 4n layout has no
+ *        contiguous levels to split, so the tree is cut a few levels
+ *        below the root into subtrees (about 4 per thread, for balance)
+ *        that are built in parallel; the levels above are then filled in
+ *        bottom-up on the calling thread.
+ * @param arr The input array
+ * @param n Size of the input array
+ * @param threads Number of threads to use
+ * @return A new, initialized SegmentTree
+ */
+SegmentTree createSegmentTreeParallel(int arr[], int n, int threads) {
+    SegmentTree st;
+    st.n = n;
+    // No memset: the build writes every node that a query can reach
+    st.tree = (int*)malloc(sizeof(int) * 4 * n);
+    st.lazy = (LazyTag*)calloc(4 * n, sizeof(LazyTag));
+    if (st.tree == NULL || st.lazy == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    int depth = 0;
+    while ((1 << depth) < 4 * threads && depth < 20) {
+        depth++;
+    }
+    BuildJob job = {&st, arr, NULL, NULL, NULL};
+    job.nodes = (int*)malloc(sizeof(int) * (3 << depth));
+    job.starts = job.nodes + (1 << depth);
+    job.ends = job.starts + (1 << depth);
+    int count = 0;
+    collectSubtrees(&job, &count, 0, 0, n - 1, depth);
+
+    parallelFor(buildSubtreeTask, &job, count, threads);
+    buildTop(&st, 0, 0, n - 1, depth);
+    free(job.nodes);
+    return st;
+}
+
+/**
+ * @brief Range sum that only reads the tree. Instead of pushing a lazy
+ *        tag down, it accounts for it: an assignment makes the whole
+ *        segment uniform, and a pending add covers every element of the
+ *        overlap. Safe to run on many threads at once.
+ */
+int queryReadOnly(const SegmentTree* st, int node, int start, int end, int L, int R) {
+    // No overlap
+    if (start > R || end < L) {
+        return 0;
+    }
+    // Total overlap: tree[node] already includes this node's own tag
+    if (L <= start && end <= R) {
+        return st->tree[node];
+    }
+    // Partial overlap
+    LazyTag tag = st->lazy[node];
+    int overlap = (end < R ? end : R) - (start > L ? start : L) + 1;
+    if (tag.hasAssign) {
+        return (tag.assign + tag.add) * overlap;
+    }
+    int mid = (start + end) / 2;
+    return queryReadOnly(st, 2 * node + 1, start, mid, L, R) +
+           queryReadOnly(st, 2 * node + 2, mid + 1, end, L, R) + tag.add * overlap;
+}
+
+// One batch of queries, split into equal chunks of 'order'
+typedef struct {
+    const SegmentTree* st;
+    const int* Ls;
+    const int* Rs;
+    int* out;
+    const int* order;  // Query indices in execution order, or NULL for 0..m-1
+    int m;
+    int chunks;
+} BatchJob;
+
+static void queryChunkTask(void* arg, int chunk) {
+    BatchJob* job = (BatchJob*)arg;
+    int begin = (int)((long long)job->m * chunk / job->chunks);
+    int end = (int)((long long)job->m * (chunk + 1) / job->chunks);
+    for (int k = begin; k < end; k++) {
+        int q = job->order ? job->order[k] : k;
+        if (job->Ls[q] < 0 || job->Rs[q] > job->st->n - 1 || job->Ls[q] > job->Rs[q]) {
+            job->out[q] = -1; // Invalid range, as in query()
+        } else {
+            job->out[q] = queryReadOnly(job->st, 0, 0, job->st->n - 1, job->Ls[q], job->Rs[q]);
+        }
+    }
+}
+
+static void runBatch(SegmentTree* st, const int Ls[], const int Rs[], int out[], int m, int threads, const int* order) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    // A few chunks per thread, so one slow chunk does not hold up the batch
+    BatchJob job = {st, Ls, Rs, out, order, m, threads == 1 ? 1 : 8 * threads};
+    parallelFor(queryChunkTask, &job, job.chunks, threads);
+}
+
+/**
+ * @brief Answers m independent range-sum queries, out[i] = sum of
+ *        [Ls[i], Rs[i]], on 'threads' threads. The tree must not change
+ *        during the call. Batches from different threads may overlap in
+ *        time; they share one pool and run one after the other.
+ */
+void query_batch(SegmentTree* st, const int Ls[], const int Rs[], int out[], int m, int threads) {
+    runBatch(st, Ls, Rs, out, m, threads, NULL);
+}
+
+// A query's left end, carried along with its index through the sort
+typedef struct {
+    int key;
+    int index;
+} KeyIndex;
+
+static int compareByKey(const void* a, const void* b) {
+    int x = ((const KeyIndex*)a)->key, y = ((const KeyIndex*)b)->key;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief query_batch, but the queries are first sorted by left end, so
+ *        each thread gets a contiguous slice of the array and consecutive
+ *        queries walk mostly the same, already cached, tree paths.
+ */
+void query_batch_sorted(SegmentTree* st, const int Ls[], const int Rs[], int out[], int m, int threads) {
+    KeyIndex* pairs = (KeyIndex*)malloc(sizeof(KeyIndex) * m);
+    int* order = (int*)malloc(sizeof(int) * m);
+    if (pairs == NULL || order == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (int i = 0; i < m; i++) {
+        pairs[i] = (KeyIndex){Ls[i], i};
+    }
+    qsort(pairs, m, sizeof(KeyIndex), compareByKey);
+    for (int i = 0; i < m; i++) {
+        order[i] = pairs[i].index;
+    }
+    free(pairs);
+    runBatch(st, Ls, Rs, out, m, threads, order);
+    free(order);
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Wall-clock time of the parallel build and of batched queries
+ *        (unsorted and sorted) for 1, 2, 4 and 8 threads.
+ */
+void benchmarkParallel(int n, int m) {
+    int* arr = (int*)malloc(sizeof(int) * n);
+    int* Ls = (int*)malloc(sizeof(int) * m);
+    int* Rs = (int*)malloc(sizeof(int) * m);
+    int* out = (int*)malloc(sizeof(int) * m);
+    for (int i = 0; i < n; i++) arr[i] = rand() % 10;
+    for (int i = 0; i < m; i++) {
+        int a = rand() % n, b = rand() % n;
+        Ls[i] = a < b ? a : b;
+        Rs[i] = a < b ? b : a;
+    }
+
+    double t0 = nowSeconds();
+    SegmentTree serial = createSegmentTree(arr, n);
+    double serialBuild = nowSeconds() - t0;
+    long long reference = 0;
+    for (int i = 0; i < m; i++) reference += query(&serial, Ls[i], Rs[i]);
+    freeSegmentTree(&serial);
+
+    printf("n = %d, %d queries, %ld CPUs (wall clock; serial build %.1f ms)\n",
+           n, m, sysconf(_SC_NPROCESSORS_ONLN), serialBuild * 1e3);
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        t0 = nowSeconds();
+        SegmentTree st = createSegmentTreeParallel(arr, n, threads);
+        double t1 = nowSeconds();
+        query_batch(&st, Ls, Rs, out, m, threads);
+        double t2 = nowSeconds();
+        long long check = 0, checkSorted = 0;
+        for (int i = 0; i < m; i++) check += out[i];
+        double t3 = nowSeconds();
+        query_batch_sorted(&st, Ls, Rs, out, m, threads);
+        double t4 = nowSeconds();
+        for (int i = 0; i < m; i++) checkSorted += out[i];
+
+        printf("  %d threads: build %7.1f ms, batch %6.1f ns/query, sorted batch %6.1f ns/query%s\n",
+               threads, (t1 - t0) * 1e3, (t2 - t1) * 1e9 / m, (t4 - t3) * 1e9 / m,
+               check == reference && checkSorted == reference ? "" : " (MISMATCH)");
+        freeSegmentTree(&st);
+    }
+
+    free(arr);
+    free(Ls);
+    free(Rs);
+    free(out);
+}
+
 // --- Example Usage ---
+// Each file in this directory is one standalone program. Files that
+// build on another one (fenwick_tree.c and blocked_segment_tree.c on this
+// file, sharded_splay.c on splay_tree.c) compile it into themselves:
+//
+//   #define main segmentTreeDemo
+//   #include "segment_tree.c"
+//   #undef main
+//
+// The demo main below then becomes an ordinary, unused function, and the
+// includer supplies its own main.
 int main() {
     int arr[] = {1, 3, 5, 7, 9, 11};
     int n = sizeof(arr) / sizeof(arr[0]);
@@ -181,8 +859,87 @@ int main() {
     // Query: Full range (1 + 3 + 6 + 7 + 9 + 11)
     printf("Sum of range [0, 5] after update: %d\n", query(&st, 0, 5)); // Output: 37
 
+    // Range add: arr[0..2] += 10 -> {11, 13, 16, 7, 9, 11}
+    range_add(&st, 0, 2, 10);
+    printf("Sum of range [1, 3] after adding 10 to [0, 2]: %d\n", query(&st, 1, 3)); // Output: 36
+
+    // Range assign: arr[2..4] = 1 -> {11, 13, 1, 1, 1, 11}
+    range_assign(&st, 2, 4, 1);
+    range_add(&st, 3, 5, 2); // -> {11, 13, 1, 3, 3, 13}
+    printf("Sum of range [0, 5] after assign and add: %d\n", query(&st, 0, 5)); // Output: 44
+
+    // Prefix sums are now 11, 24, 25, 28, 31, 44
+    printf("First index with prefix sum >= 25: %d, >= 26: %d, >= 45: %d\n",
+           prefixLowerBound(&st, 25), prefixLowerBound(&st, 26), prefixLowerBound(&st, 45)); // 2, 3, -1
+
     // Clean up
     freeSegmentTree(&st);
 
+    // Range adds of 10^5 entries: lazy range_add vs. one update per entry
+    int big = 1000000, width = 100000, rounds = 100;
+    int* values = (int*)calloc(big, sizeof(int));
+    SegmentTree a = createSegmentTree(values, big);
+    SegmentTree b = createSegmentTree(values, big);
+    srand(42);
+
+    clock_t t0 = clock();
+    for (int r = 0; r < rounds; r++) {
+        int L = rand() % (big - width);
+        range_add(&a, L, L + width - 1, 1);
+    }
+    clock_t t1 = clock();
+    srand(42);
+    for (int r = 0; r < rounds; r++) {
+        int L = rand() % (big - width);
+        for (int i = L; i < L + width; i++) {
+            values[i] += 1;
+            update(&b, i, values[i]);
+        }
+    }
+    clock_t t2 = clock();
+    printf("\n%d range adds of %d entries: range_add %.2f us, point updates %.2f us (sums %d / %d)\n",
+           rounds, width, (t1 - t0) * 1e6 / CLOCKS_PER_SEC / rounds,
+           (t2 - t1) * 1e6 / CLOCKS_PER_SEC / rounds, query(&a, 0, big - 1), query(&b, 0, big - 1));
+
+    // Weighted sampling on the result: descent vs. binary search over query()
+    int total = query(&a, 0, big - 1), samples = 1000000;
+    long long picked[2] = {0, 0};
+    srand(7);
+    t0 = clock();
+    for (int i = 0; i < samples; i++) {
+        picked[0] += prefixLowerBound(&a, 1 + (int)((long long)rand() * rand() % total));
+    }
+    t1 = clock();
+    srand(7);
+    for (int i = 0; i < samples; i++) {
+        int k = 1 + (int)((long long)rand() * rand() % total);
+        int lo = 0, hi = big - 1;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (query(&a, 0, mid) >= k) hi = mid;
+            else lo = mid + 1;
+        }
+        picked[1] += lo;
+    }
+    t2 = clock();
+    printf("%d weighted samples: descent %.1f ns, binary search over query %.1f ns%s\n",
+           samples, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / samples,
+           (t2 - t1) * 1e9 / CLOCKS_PER_SEC / samples, picked[0] == picked[1] ? "" : " (MISMATCH)");
+
+    freeSegmentTree(&a);
+    freeSegmentTree(&b);
+    free(values);
+
+    // Iterative 2n tree vs. recursive 4n tree
+    printf("\n");
+    for (int size = 1000; size <= 100000000; size *= 10) {
+        benchmarkIterative(size, 1000000);
+    }
+
+    // Parallel build and batched queries
+    printf("\n");
+    benchmarkParallel(10000000, 2000000);
+    freeThreadPool();
+
     return 0;
 }
\ No newline at end of file
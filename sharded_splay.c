@@ -0,0 +1,371 @@
+#define _GNU_SOURCE
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<pthread.h>
+#include<sched.h>
+#include<time.h>
+#include<unistd.h>
+
+// Shards are splay_tree.c's SplayTree handles (include idiom: see
+// segment_tree.c's main)
+#define main splayTreeDemo
+#include "splay_tree.c"
+#undef main
+
+// Sharded splay trees: the key space is hashed over several SplayTree
+// handles (see splay_tree.c) and each tree is owned by one worker thread,
+// pinned to its own core. A splay restructures the tree even on a
+// search, so instead of locking a shared tree, client threads group
+// their requests by shard and hand each worker a whole batch at once;
+// the worker is the only thread that ever touches its tree, and one
+// queue lock is paid per batch instead of per operation.
+//
+// Requests for the same key always go to the same shard, in submission
+// order, so a batch sees its own earlier inserts and deletes.
+
+// --- Sharded front end ---
+
+#define CACHE_LINE 64
+
+typedef enum { OP_INSERT, OP_DELETE, OP_CONTAINS } OpType;
+
+typedef struct {
+    OpType op;
+    int key;
+    int result;             // Filled in by the owning shard: 1 if found / removed
+} Request;
+
+// Lets a client sleep until every batch it submitted has been processed
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    int pending;            // Batches not yet finished
+} Completion;
+
+// The requests of one client call that hash to one shard
+typedef struct Batch {
+    Request **reqs;
+    int n;
+    Completion *completion;
+    struct Batch *next;     // Shard queue link
+} Batch;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    Batch *head;            // FIFO of submitted batches
+    Batch *tail;
+    int stop;
+    SplayTree *tree;        // Only ever touched by the worker thread
+    pthread_t thread;
+    int cpu;
+} __attribute__((aligned(CACHE_LINE))) Shard;
+
+typedef struct {
+    Shard *shards;
+    int numShards;
+} ShardedSplay;
+
+// Per-thread submission state: one reusable batch per shard
+typedef struct {
+    ShardedSplay *s;
+    Batch *batches;
+    int maxBatch;           // Capacity of each batch
+    Completion completion;
+} ShardClient;
+
+static int shardOf(ShardedSplay *s, int key) {
+    // Fibonacci hashing, so runs of nearby keys spread over all shards
+    uint32_t h = (uint32_t)(((uint64_t)(uint32_t)key * 0x9E3779B97F4A7C15ull) >> 32);
+    return (int)(((uint64_t)h * (uint32_t)s->numShards) >> 32);
+}
+
+static void runBatch(SplayTree *tree, Batch *b) {
+    for (int i = 0; i < b->n; i++) {
+        Request *r = b->reqs[i];
+        switch (r->op) {
+        case OP_INSERT:
+            splayTreeInsert(tree, r->key);
+            r->result = 1;
+            break;
+        case OP_DELETE:
+            r->result = splayTreeDelete(tree, r->key);
+            break;
+        case OP_CONTAINS:
+            r->result = splayTreeContains(tree, r->key);
+            break;
+        }
+    }
+}
+
+static void *shardWorker(void *arg) {
+    Shard *shard = (Shard*)arg;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(shard->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // Best effort
+
+    while (1) {
+        pthread_mutex_lock(&shard->lock);
+        while (shard->head == NULL && !shard->stop)
+            pthread_cond_wait(&shard->ready, &shard->lock);
+        Batch *b = shard->head; // Take the whole queue
+        shard->head = shard->tail = NULL;
+        int stop = shard->stop;
+        pthread_mutex_unlock(&shard->lock);
+
+        while (b != NULL) {
+            Batch *next = b->next; // b belongs to the client again once signalled
+            runBatch(shard->tree, b);
+            Completion *c = b->completion;
+            pthread_mutex_lock(&c->lock);
+            if (--c->pending == 0) pthread_cond_signal(&c->done);
+            pthread_mutex_unlock(&c->lock);
+            b = next;
+        }
+        if (stop) break;
+    }
+    return NULL;
+}
+
+// Start numShards worker threads, pinned round-robin over the online CPUs
+ShardedSplay *createShardedSplay(int numShards) {
+    ShardedSplay *s = (ShardedSplay*)malloc(sizeof(ShardedSplay));
+    s->numShards = numShards;
+    if (posix_memalign((void**)&s->shards, CACHE_LINE, sizeof(Shard) * numShards) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    for (int i = 0; i < numShards; i++) {
+        Shard *shard = &s->shards[i];
+        pthread_mutex_init(&shard->lock, NULL);
+        pthread_cond_init(&shard->ready, NULL);
+        shard->head = shard->tail = NULL;
+        shard->stop = 0;
+        shard->tree = createSplayTree();
+        shard->cpu = (int)(i % cpus);
+        pthread_create(&shard->thread, NULL, shardWorker, shard);
+    }
+    return s;
+}
+
+// Stop the workers (after they drain their queues) and free every tree
+void freeShardedSplay(ShardedSplay *s) {
+    for (int i = 0; i < s->numShards; i++) {
+        Shard *shard = &s->shards[i];
+        pthread_mutex_lock(&shard->lock);
+        shard->stop = 1;
+        pthread_cond_signal(&shard->ready);
+        pthread_mutex_unlock(&shard->lock);
+    }
+    for (int i = 0; i < s->numShards; i++) {
+        Shard *shard = &s->shards[i];
+        pthread_join(shard->thread, NULL);
+        freeSplayTree(shard->tree);
+        pthread_mutex_destroy(&shard->lock);
+        pthread_cond_destroy(&shard->ready);
+    }
+    free(s->shards);
+    free(s);
+}
+
+// A client hands the shards at most maxBatch requests at a time;
+// shardedExecute splits larger calls
+ShardClient *createShardClient(ShardedSplay *s, int maxBatch) {
+    ShardClient *c = (ShardClient*)malloc(sizeof(ShardClient));
+    c->s = s;
+    c->maxBatch = maxBatch < 1 ? 1 : maxBatch;
+    c->batches = (Batch*)malloc(sizeof(Batch) * s->numShards);
+    for (int i = 0; i < s->numShards; i++) {
+        c->batches[i].reqs = (Request**)malloc(sizeof(Request*) * c->maxBatch);
+        c->batches[i].completion = &c->completion;
+    }
+    pthread_mutex_init(&c->completion.lock, NULL);
+    pthread_cond_init(&c->completion.done, NULL);
+    return c;
+}
+
+void freeShardClient(ShardClient *c) {
+    for (int i = 0; i < c->s->numShards; i++) free(c->batches[i].reqs);
+    free(c->batches);
+    pthread_mutex_destroy(&c->completion.lock);
+    pthread_cond_destroy(&c->completion.done);
+    free(c);
+}
+
+// Submit reqs[0, n), n <= maxBatch, and wait for all of them
+static void executeChunk(ShardClient *c, Request reqs[], int n) {
+    ShardedSplay *s = c->s;
+    for (int i = 0; i < s->numShards; i++) c->batches[i].n = 0;
+    for (int i = 0; i < n; i++) {
+        Batch *b = &c->batches[shardOf(s, reqs[i].key)];
+        b->reqs[b->n++] = &reqs[i];
+    }
+
+    // Count the batches before submitting any, so no early finish sees 0
+    int pending = 0;
+    for (int i = 0; i < s->numShards; i++) pending += c->batches[i].n > 0;
+    if (pending == 0) return;
+    c->completion.pending = pending;
+
+    for (int i = 0; i < s->numShards; i++) {
+        Batch *b = &c->batches[i];
+        if (b->n == 0) continue;
+        Shard *shard = &s->shards[i];
+        b->next = NULL;
+        pthread_mutex_lock(&shard->lock);
+        if (shard->tail) shard->tail->next = b;
+        else shard->head = b;
+        shard->tail = b;
+        pthread_cond_signal(&shard->ready);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    pthread_mutex_lock(&c->completion.lock);
+    while (c->completion.pending > 0)
+        pthread_cond_wait(&c->completion.done, &c->completion.lock);
+    pthread_mutex_unlock(&c->completion.lock);
+}
+
+// Run reqs[0, n) and wait for all of them; results are written into reqs.
+// Calls longer than maxBatch run as consecutive chunks, in order.
+void shardedExecute(ShardClient *c, Request reqs[], int n) {
+    for (int done = 0; done < n; done += c->maxBatch) {
+        int len = n - done < c->maxBatch ? n - done : c->maxBatch;
+        executeChunk(c, reqs + done, len);
+    }
+}
+
+// --- Benchmark: one mutex-protected tree vs. sharded trees ---
+
+typedef struct {
+    SplayTree *tree;
+    pthread_mutex_t lock;
+} LockedSplay;
+
+typedef struct {
+    LockedSplay *locked;    // Exactly one of locked / sharded is set
+    ShardedSplay *sharded;
+    int ops;
+    int batch;
+    int keyRange;
+    unsigned seed;
+    long long hits;
+} ClientArgs;
+
+static void randomRequest(Request *r, int keyRange, unsigned *seed) {
+    int p = rand_r(seed) % 100;
+    r->op = p < 90 ? OP_CONTAINS : (p < 95 ? OP_INSERT : OP_DELETE);
+    r->key = rand_r(seed) % keyRange;
+}
+
+static void *lockedClient(void *arg) {
+    ClientArgs *a = (ClientArgs*)arg;
+    Request r;
+    for (int i = 0; i < a->ops; i++) {
+        randomRequest(&r, a->keyRange, &a->seed);
+        pthread_mutex_lock(&a->locked->lock);
+        if (r.op == OP_INSERT) splayTreeInsert(a->locked->tree, r.key);
+        else if (r.op == OP_DELETE) a->hits += splayTreeDelete(a->locked->tree, r.key);
+        else a->hits += splayTreeContains(a->locked->tree, r.key);
+        pthread_mutex_unlock(&a->locked->lock);
+    }
+    return NULL;
+}
+
+static void *shardedClient(void *arg) {
+    ClientArgs *a = (ClientArgs*)arg;
+    ShardClient *c = createShardClient(a->sharded, a->batch);
+    Request *reqs = (Request*)malloc(sizeof(Request) * a->batch);
+    for (int done = 0; done < a->ops; done += a->batch) {
+        int n = a->ops - done < a->batch ? a->ops - done : a->batch;
+        for (int i = 0; i < n; i++) randomRequest(&reqs[i], a->keyRange, &a->seed);
+        shardedExecute(c, reqs, n);
+        for (int i = 0; i < n; i++)
+            if (reqs[i].op != OP_INSERT) a->hits += reqs[i].result;
+    }
+    free(reqs);
+    freeShardClient(c);
+    return NULL;
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Run clients threads of opsPerClient requests each; returns Mops/s
+static double runClients(int clients, LockedSplay *locked, ShardedSplay *sharded, int opsPerClient, int batch, int keyRange) {
+    pthread_t *threads = (pthread_t*)malloc(sizeof(pthread_t) * clients);
+    ClientArgs *args = (ClientArgs*)malloc(sizeof(ClientArgs) * clients);
+    double start = nowSeconds();
+    for (int i = 0; i < clients; i++) {
+        args[i] = (ClientArgs){locked, sharded, opsPerClient, batch, keyRange, 1234u + i, 0};
+        pthread_create(&threads[i], NULL, sharded ? shardedClient : lockedClient, &args[i]);
+    }
+    for (int i = 0; i < clients; i++) pthread_join(threads[i], NULL);
+    double elapsed = nowSeconds() - start;
+    free(threads);
+    free(args);
+    return (double)clients * opsPerClient / elapsed / 1e6;
+}
+
+void benchmarkSharded(int keyRange, int opsPerClient) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int numShards = cpus < 2 ? 2 : (int)cpus;
+    int batches[] = {1, 64, 1024};
+    printf("%d keys, 90%% contains / 5%% insert / 5%% delete, %d shards on %ld CPUs (Mops/s)\n",
+           keyRange, numShards, cpus);
+    printf("clients   mutex   sharded b=1   b=64   b=1024\n");
+
+    for (int clients = 1; clients <= 8; clients *= 2) {
+        LockedSplay locked = {createSplayTree(), PTHREAD_MUTEX_INITIALIZER};
+        for (int k = 0; k < keyRange; k += 2) splayTreeInsert(locked.tree, k);
+        double mutexRate = runClients(clients, &locked, NULL, opsPerClient, 1, keyRange);
+        freeSplayTree(locked.tree);
+        printf("%7d %7.2f", clients, mutexRate);
+
+        for (int b = 0; b < 3; b++) {
+            ShardedSplay *s = createShardedSplay(numShards);
+            ShardClient *loader = createShardClient(s, keyRange);
+            Request *fill = (Request*)malloc(sizeof(Request) * keyRange);
+            int n = 0;
+            for (int k = 0; k < keyRange; k += 2) fill[n++] = (Request){OP_INSERT, k, 0};
+            shardedExecute(loader, fill, n);
+            free(fill);
+            freeShardClient(loader);
+            printf(" %*.2f", b == 0 ? 13 : 7, runClients(clients, NULL, s, opsPerClient, batches[b], keyRange));
+            freeShardedSplay(s);
+        }
+        printf("\n");
+    }
+}
+
+int main() {
+    ShardedSplay *s = createShardedSplay(4);
+    ShardClient *c = createShardClient(s, 4); // The 10 requests below run as 3 chunks
+
+    Request reqs[] = {
+        {OP_INSERT, 10, 0}, {OP_INSERT, 4, 0}, {OP_INSERT, 5, 0}, {OP_INSERT, 2, 0},
+        {OP_CONTAINS, 4, 0}, {OP_DELETE, 4, 0}, {OP_CONTAINS, 4, 0}, {OP_CONTAINS, 7, 0},
+        {OP_DELETE, 7, 0}, {OP_CONTAINS, 10, 0},
+    };
+    const char *names[] = {"insert", "delete", "contains"};
+    int n = sizeof(reqs) / sizeof(reqs[0]);
+    shardedExecute(c, reqs, n);
+    for (int i = 0; i < n; i++)
+        printf("%-8s %2d -> shard %d, result %d\n", names[reqs[i].op], reqs[i].key,
+               shardOf(s, reqs[i].key), reqs[i].result);
+    printf("\n");
+
+    freeShardClient(c);
+    freeShardedSplay(s);
+
+    benchmarkSharded(1 << 20, 100000);
+    return 0;
+}
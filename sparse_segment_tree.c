@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+// Dynamic (sparse) segment tree over the whole 64-bit coordinate space
+// [0, 2^64 - 1]. segment_tree.c needs a dense array of n elements; here a
+// node is created only when an update passes through it, so memory is
+// O(updates * 64) nodes no matter how far apart the coordinates are, and
+// a missing child stands for a segment of zeros.
+//
+// Nodes come from an arena of fixed-size chunks and are named by 32-bit
+// index. Chunks never move, so growing the arena copies nothing, and the
+// whole tree is released by freeing the chunks.
+
+#define CHUNK_BITS 16
+#define CHUNK_SIZE (1 << CHUNK_BITS)
+#define MAX_DEPTH 65 // Root plus one level per coordinate bit
+
+typedef struct {
+    long long sum;
+    uint32_t left;  // Arena index of the left child, 0 if none
+    uint32_t right; // Arena index of the right child, 0 if none
+} SparseNode;
+
+typedef struct {
+    SparseNode** chunks;
+    int numChunks;
+    int capChunks;
+    uint32_t used;  // Nodes handed out; index 0 is the shared "no node"
+} SparseSegmentTree;
+
+/**
+ * @brief Address of node i in the arena.
+ */
+static inline SparseNode* node(SparseSegmentTree* st, uint32_t i) {
+    return &st->chunks[i >> CHUNK_BITS][i & (CHUNK_SIZE - 1)];
+}
+
+/**
+ * @brief Takes a zeroed node from the arena, adding a chunk if needed.
+ * @return Index of the new node
+ */
+uint32_t allocNode(SparseSegmentTree* st) {
+    if ((st->used & (CHUNK_SIZE - 1)) == 0) {
+        if (st->numChunks == 1 << (32 - CHUNK_BITS)) {
+            fprintf(stderr, "Arena full: 2^32 nodes\n");
+            exit(1);
+        }
+        if (st->numChunks == st->capChunks) {
+            st->capChunks *= 2;
+            st->chunks = (SparseNode**)realloc(st->chunks, sizeof(SparseNode*) * st->capChunks);
+        }
+        SparseNode* chunk = (SparseNode*)calloc(CHUNK_SIZE, sizeof(SparseNode));
+        if (st->chunks == NULL || chunk == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+        st->chunks[st->numChunks++] = chunk;
+    }
+    return st->used++;
+}
+
+/**
+ * @brief Creates an empty tree: every coordinate holds 0.
+ */
+SparseSegmentTree createSparseSegmentTree() {
+    SparseSegmentTree st;
+    st.numChunks = 0;
+    st.capChunks = 16;
+    st.chunks = (SparseNode**)malloc(sizeof(SparseNode*) * st.capChunks);
+    st.used = 0;
+    allocNode(&st); // Index 0: "no node"
+    allocNode(&st); // Index 1: the root, covering [0, 2^64 - 1]
+    return st;
+}
+
+/**
+ * @brief Sets coordinate idx to newValue, creating the nodes on its path.
+ */
+void update(SparseSegmentTree* st, uint64_t idx, long long newValue) {
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    uint32_t cur = 1;
+    uint64_t start = 0, end = UINT64_MAX;
+
+    // Walk down, creating missing children
+    while (start != end) {
+        path[depth++] = cur;
+        uint64_t mid = start + (end - start) / 2;
+        uint32_t* child;
+        if (idx <= mid) {
+            child = &node(st, cur)->left;
+            end = mid;
+        } else {
+            child = &node(st, cur)->right;
+            start = mid + 1;
+        }
+        if (*child == 0) {
+            uint32_t fresh = allocNode(st); // Chunks never move, so child stays valid
+            *child = fresh;
+        }
+        cur = *child;
+    }
+    node(st, cur)->sum = newValue;
+
+    // Re-calculate the sums on the way back up
+    while (depth > 0) {
+        SparseNode* n = node(st, path[--depth]);
+        n->sum = node(st, n->left)->sum + node(st, n->right)->sum; // Node 0 has sum 0
+    }
+}
+
+/**
+ * @brief Recursive function for range sum query; absent nodes are zeros.
+ */
+long long queryRecursive(SparseSegmentTree* st, uint32_t cur, uint64_t start, uint64_t end, uint64_t L, uint64_t R) {
+    // No node, or no overlap
+    if (cur == 0 || start > R || end < L) {
+        return 0;
+    }
+    // Total overlap
+    if (L <= start && end <= R) {
+        return node(st, cur)->sum;
+    }
+    // Partial overlap
+    uint64_t mid = start + (end - start) / 2;
+    SparseNode* n = node(st, cur);
+    return queryRecursive(st, n->left, start, mid, L, R) +
+           queryRecursive(st, n->right, mid + 1, end, L, R);
+}
+
+/**
+ * @brief Sum of the values at coordinates [L, R].
+ */
+long long query(SparseSegmentTree* st, uint64_t L, uint64_t R) {
+    if (L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    return queryRecursive(st, 1, 0, UINT64_MAX, L, R);
+}
+
+/**
+ * @brief Frees every node at once by releasing the arena.
+ */
+void freeSparseSegmentTree(SparseSegmentTree* st) {
+    for (int i = 0; i < st->numChunks; i++) {
+        free(st->chunks[i]);
+    }
+    free(st->chunks);
+    st->chunks = NULL;
+    st->numChunks = st->capChunks = 0;
+    st->used = 0;
+}
+
+static uint64_t random64() {
+    return ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+}
+
+// --- Example Usage ---
+int main() {
+    SparseSegmentTree st = createSparseSegmentTree();
+
+    // Bytes received, keyed by nanosecond timestamp
+    uint64_t t = 1700000000000000000ULL;
+    update(&st, t, 1500);
+    update(&st, t + 250, 9000);
+    update(&st, t + 1000000000ULL, 64);  // One second later
+    update(&st, UINT64_MAX, 7);          // The very last coordinate
+
+    printf("Bytes in the first microsecond: %lld\n", query(&st, t, t + 999));            // 10500
+    printf("Bytes in the first two seconds: %lld\n", query(&st, t, t + 2000000000ULL));  // 10564
+    printf("Whole coordinate space: %lld\n", query(&st, 0, UINT64_MAX));                 // 10571
+
+    update(&st, t + 250, 0);
+    printf("After clearing t + 250: %lld\n", query(&st, t, t + 999));                    // 1500
+    printf("Nodes allocated: %u\n\n", st.used - 1);
+    freeSparseSegmentTree(&st);
+
+    // Random 64-bit IDs
+    int updates = 200000, queries = 1000000;
+    uint64_t* keys = (uint64_t*)malloc(sizeof(uint64_t) * updates);
+    srand(42);
+    st = createSparseSegmentTree();
+
+    clock_t t0 = clock();
+    for (int i = 0; i < updates; i++) {
+        keys[i] = random64();
+        update(&st, keys[i], rand() % 1000);
+    }
+    clock_t t1 = clock();
+    long long checksum = 0;
+    for (int q = 0; q < queries; q++) {
+        uint64_t a = keys[rand() % updates], b = random64();
+        checksum += query(&st, a < b ? a : b, a < b ? b : a);
+    }
+    clock_t t2 = clock();
+
+    printf("%d updates at random 64-bit coordinates: %.1f ns/update, query %.1f ns (checksum %lld)\n",
+           updates, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / updates,
+           (t2 - t1) * 1e9 / CLOCKS_PER_SEC / queries, checksum);
+    printf("Arena: %u nodes, %.1f MB, %.0f bytes per update\n", st.used - 1,
+           (double)st.numChunks * CHUNK_SIZE * sizeof(SparseNode) / (1 << 20),
+           (double)(st.used - 1) * sizeof(SparseNode) / updates);
+
+    freeSparseSegmentTree(&st);
+    free(keys);
+    return 0;
+}
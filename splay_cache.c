@@ -0,0 +1,483 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+// In-process cache on a splay tree. Every cache_get/cache_put splays the
+// key to the root, so hot keys stay near the top without a hash table.
+// Capacity is in bytes; when a put goes over it, entries are evicted
+// either by recency (intrusive LRU list) or by frequency (LFU, with
+// frequency buckets so the least used entry is found in O(1)).
+
+typedef enum { EVICT_LRU, EVICT_LFU } EvictPolicy;
+
+struct FreqBucket;
+
+typedef struct CacheNode {
+    long key;
+    void *value;                // Cache-owned copy of the payload
+    size_t size;                // Payload size in bytes
+    struct CacheNode *left;     // Splay tree links
+    struct CacheNode *right;
+    struct CacheNode *prev;     // Recency list (LRU) or bucket list (LFU)
+    struct CacheNode *next;
+    struct FreqBucket *bucket;  // LFU only
+} CacheNode;
+
+// All LFU entries with the same access count, most recent first
+typedef struct FreqBucket {
+    unsigned long freq;
+    CacheNode *head;
+    CacheNode *tail;
+    struct FreqBucket *prev;
+    struct FreqBucket *next;
+} FreqBucket;
+
+typedef struct {
+    CacheNode *root;
+    EvictPolicy policy;
+    size_t capacity;            // Bytes
+    size_t used;                // Bytes
+    size_t count;
+    CacheNode *head;            // LRU: most recently used
+    CacheNode *tail;            // LRU: least recently used
+    FreqBucket *buckets;        // LFU: lowest frequency first
+    unsigned long hits;
+    unsigned long misses;
+} SplayCache;
+
+// --- Splay tree ---
+
+CacheNode *rightRotate(CacheNode *x) {
+    CacheNode *y = x->left;
+    x->left = y->right;
+    y->right = x;
+    return y;
+}
+
+CacheNode *leftRotate(CacheNode *x) {
+    CacheNode *y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+// Top-down splay, as topDownSplay in splay_tree.c
+CacheNode *splay(CacheNode *root, long key) {
+    if (root == NULL) return NULL;
+
+    CacheNode header;
+    header.left = header.right = NULL;
+    CacheNode *leftMax = &header;
+    CacheNode *rightMin = &header;
+
+    while (1) {
+        if (key < root->key) {
+            if (root->left == NULL) break;
+            if (key < root->left->key) {
+                root = rightRotate(root); // Zig-zig
+                if (root->left == NULL) break;
+            }
+            rightMin->left = root;
+            rightMin = root;
+            root = root->left;
+        }
+        else if (key > root->key) {
+            if (root->right == NULL) break;
+            if (key > root->right->key) {
+                root = leftRotate(root); // Zig-zig
+                if (root->right == NULL) break;
+            }
+            leftMax->right = root;
+            leftMax = root;
+            root = root->right;
+        }
+        else {
+            break;
+        }
+    }
+
+    leftMax->right = root->left;
+    rightMin->left = root->right;
+    root->left = header.right;
+    root->right = header.left;
+    return root;
+}
+
+// Unlink the root node from the tree (keys are unique, so splaying the
+// left subtree for the root's key brings its maximum up with no right child)
+CacheNode *removeRoot(CacheNode *root) {
+    if (root->left == NULL) return root->right;
+    CacheNode *newRoot = splay(root->left, root->key);
+    newRoot->right = root->right;
+    return newRoot;
+}
+
+// --- Recency list ---
+
+static void listUnlink(CacheNode **head, CacheNode **tail, CacheNode *node) {
+    if (node->prev) node->prev->next = node->next;
+    else *head = node->next;
+    if (node->next) node->next->prev = node->prev;
+    else *tail = node->prev;
+    node->prev = node->next = NULL;
+}
+
+static void listPushFront(CacheNode **head, CacheNode **tail, CacheNode *node) {
+    node->prev = NULL;
+    node->next = *head;
+    if (*head) (*head)->prev = node;
+    else *tail = node;
+    *head = node;
+}
+
+// --- Frequency buckets ---
+
+static FreqBucket *newBucket(unsigned long freq, FreqBucket *prev, FreqBucket *next) {
+    FreqBucket *b = (FreqBucket*)malloc(sizeof(FreqBucket));
+    b->freq = freq;
+    b->head = b->tail = NULL;
+    b->prev = prev;
+    b->next = next;
+    return b;
+}
+
+static void dropBucketIfEmpty(SplayCache *cache, FreqBucket *b) {
+    if (b->head != NULL) return;
+    if (b->prev) b->prev->next = b->next;
+    else cache->buckets = b->next;
+    if (b->next) b->next->prev = b->prev;
+    free(b);
+}
+
+// Move node to the bucket for freq + 1 (creating it next to the old one)
+static void lfuTouch(SplayCache *cache, CacheNode *node) {
+    FreqBucket *b = node->bucket;
+    FreqBucket *target = b->next;
+    if (target == NULL || target->freq != b->freq + 1) {
+        target = newBucket(b->freq + 1, b, b->next);
+        if (b->next) b->next->prev = target;
+        b->next = target;
+    }
+    listUnlink(&b->head, &b->tail, node);
+    listPushFront(&target->head, &target->tail, node);
+    node->bucket = target;
+    dropBucketIfEmpty(cache, b);
+}
+
+static void lfuAdd(SplayCache *cache, CacheNode *node) {
+    FreqBucket *b = cache->buckets;
+    if (b == NULL || b->freq != 1) {
+        b = newBucket(1, NULL, cache->buckets);
+        if (cache->buckets) cache->buckets->prev = b;
+        cache->buckets = b;
+    }
+    listPushFront(&b->head, &b->tail, node);
+    node->bucket = b;
+}
+
+// --- Cache ---
+
+SplayCache *createCache(size_t capacity, EvictPolicy policy) {
+    SplayCache *cache = (SplayCache*)calloc(1, sizeof(SplayCache));
+    cache->capacity = capacity;
+    cache->policy = policy;
+    return cache;
+}
+
+static void touch(SplayCache *cache, CacheNode *node) {
+    if (cache->policy == EVICT_LRU) {
+        listUnlink(&cache->head, &cache->tail, node);
+        listPushFront(&cache->head, &cache->tail, node);
+    }
+    else {
+        lfuTouch(cache, node);
+    }
+}
+
+// Remove the least recently / least frequently used entry other than keep
+static void evictOne(SplayCache *cache, CacheNode *keep) {
+    CacheNode *victim;
+    if (cache->policy == EVICT_LRU) {
+        victim = cache->tail;
+        if (victim == keep) victim = victim->prev;
+        listUnlink(&cache->head, &cache->tail, victim);
+    }
+    else {
+        FreqBucket *b = cache->buckets;
+        victim = b->tail; // Oldest among the least used
+        if (victim == keep) {
+            victim = victim->prev;
+            if (victim == NULL) {
+                b = b->next;
+                victim = b->tail;
+            }
+        }
+        listUnlink(&b->head, &b->tail, victim);
+        dropBucketIfEmpty(cache, b);
+    }
+    cache->root = removeRoot(splay(cache->root, victim->key));
+    cache->used -= victim->size;
+    cache->count--;
+    free(victim->value);
+    free(victim);
+}
+
+// Returns the cached value for key, or NULL on a miss
+void *cache_get(SplayCache *cache, long key) {
+    cache->root = splay(cache->root, key);
+    if (cache->root == NULL || cache->root->key != key) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->hits++;
+    touch(cache, cache->root);
+    return cache->root->value;
+}
+
+// Stores a copy of value under key, evicting as needed. Returns 0 if the
+// value alone is larger than the whole cache.
+int cache_put(SplayCache *cache, long key, const void *value, size_t size) {
+    if (size > cache->capacity) return 0;
+
+    void *copy = malloc(size);
+    memcpy(copy, value, size);
+
+    cache->root = splay(cache->root, key);
+    CacheNode *node = cache->root;
+    if (node != NULL && node->key == key) {
+        // Replace in place
+        cache->used = cache->used - node->size + size;
+        free(node->value);
+        node->value = copy;
+        node->size = size;
+        touch(cache, node);
+    }
+    else {
+        // Split the tree under the new node
+        node = (CacheNode*)calloc(1, sizeof(CacheNode));
+        node->key = key;
+        node->value = copy;
+        node->size = size;
+        if (cache->root != NULL) {
+            if (key < cache->root->key) {
+                node->left = cache->root->left;
+                node->right = cache->root;
+                cache->root->left = NULL;
+            }
+            else {
+                node->right = cache->root->right;
+                node->left = cache->root;
+                cache->root->right = NULL;
+            }
+        }
+        cache->root = node;
+        cache->used += size;
+        cache->count++;
+        if (cache->policy == EVICT_LRU) listPushFront(&cache->head, &cache->tail, node);
+        else lfuAdd(cache, node);
+    }
+
+    // size <= capacity, so there is always another entry to evict
+    while (cache->used > cache->capacity) {
+        evictOne(cache, node);
+    }
+    return 1;
+}
+
+void freeCache(SplayCache *cache) {
+    while (cache->count > 0) {
+        evictOne(cache, NULL);
+    }
+    free(cache);
+}
+
+// --- Baseline: chained hash table + intrusive LRU list ---
+
+typedef struct HashNode {
+    long key;
+    void *value;
+    size_t size;
+    struct HashNode *chain;
+    struct HashNode *prev;
+    struct HashNode *next;
+} HashNode;
+
+typedef struct {
+    HashNode **table;
+    size_t mask;
+    size_t capacity;
+    size_t used;
+    HashNode *head;
+    HashNode *tail;
+} HashLRU;
+
+static size_t hashKey(long key) {
+    unsigned long x = (unsigned long)key * 0x9E3779B97F4A7C15UL;
+    return (size_t)(x ^ (x >> 29));
+}
+
+HashLRU *createHashLRU(size_t capacity, size_t expectedEntries) {
+    HashLRU *h = (HashLRU*)calloc(1, sizeof(HashLRU));
+    size_t slots = 16;
+    while (slots < 2 * expectedEntries) slots *= 2;
+    h->table = (HashNode**)calloc(slots, sizeof(HashNode*));
+    h->mask = slots - 1;
+    h->capacity = capacity;
+    return h;
+}
+
+static void hashListUnlink(HashLRU *h, HashNode *n) {
+    if (n->prev) n->prev->next = n->next;
+    else h->head = n->next;
+    if (n->next) n->next->prev = n->prev;
+    else h->tail = n->prev;
+}
+
+static void hashListPushFront(HashLRU *h, HashNode *n) {
+    n->prev = NULL;
+    n->next = h->head;
+    if (h->head) h->head->prev = n;
+    else h->tail = n;
+    h->head = n;
+}
+
+void *hash_get(HashLRU *h, long key) {
+    for (HashNode *n = h->table[hashKey(key) & h->mask]; n; n = n->chain) {
+        if (n->key == key) {
+            hashListUnlink(h, n);
+            hashListPushFront(h, n);
+            return n->value;
+        }
+    }
+    return NULL;
+}
+
+void hash_put(HashLRU *h, long key, const void *value, size_t size) {
+    HashNode *n = (HashNode*)malloc(sizeof(HashNode));
+    n->key = key;
+    n->value = malloc(size);
+    memcpy(n->value, value, size);
+    n->size = size;
+    HashNode **slot = &h->table[hashKey(key) & h->mask];
+    n->chain = *slot;
+    *slot = n;
+    hashListPushFront(h, n);
+    h->used += size;
+
+    while (h->used > h->capacity) {
+        HashNode *victim = h->tail;
+        hashListUnlink(h, victim);
+        HashNode **p = &h->table[hashKey(victim->key) & h->mask];
+        while (*p != victim) p = &(*p)->chain;
+        *p = victim->chain;
+        h->used -= victim->size;
+        free(victim->value);
+        free(victim);
+    }
+}
+
+void freeHashLRU(HashLRU *h) {
+    while (h->head) {
+        HashNode *n = h->head;
+        h->head = n->next;
+        free(n->value);
+        free(n);
+    }
+    free(h->table);
+    free(h);
+}
+
+// --- Benchmark ---
+
+#define ITEM_SIZE 64
+
+// Zipf(s = 1) over n keys, scattered over a large key space
+long *zipfTrace(int n, int m) {
+    double *cdf = (double*)malloc(sizeof(double) * n);
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += 1.0 / (i + 1);
+        cdf[i] = sum;
+    }
+    long *trace = (long*)malloc(sizeof(long) * m);
+    for (int i = 0; i < m; i++) {
+        double u = (double)rand() / RAND_MAX * sum;
+        int lo = 0, hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        trace[i] = (long)lo * 2654435761L % 1000000007L;
+    }
+    free(cdf);
+    return trace;
+}
+
+// Get-or-fill every trace key; report hit ratio and ns per access
+void benchmarkCache(long *trace, int m, int universe, double fraction) {
+    size_t capacity = (size_t)(universe * fraction) * ITEM_SIZE;
+    char item[ITEM_SIZE] = {0};
+    printf("capacity %4.1f%% of keys:", fraction * 100);
+
+    for (int policy = EVICT_LRU; policy <= EVICT_LFU; policy++) {
+        SplayCache *cache = createCache(capacity, (EvictPolicy)policy);
+        clock_t t0 = clock();
+        for (int i = 0; i < m; i++) {
+            if (cache_get(cache, trace[i]) == NULL)
+                cache_put(cache, trace[i], item, ITEM_SIZE);
+        }
+        clock_t t1 = clock();
+        printf("  splay-%s hit %5.1f%% %6.1f ns", policy == EVICT_LRU ? "LRU" : "LFU",
+               100.0 * cache->hits / m, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / m);
+        freeCache(cache);
+    }
+
+    HashLRU *h = createHashLRU(capacity, capacity / ITEM_SIZE);
+    long hits = 0;
+    clock_t t0 = clock();
+    for (int i = 0; i < m; i++) {
+        if (hash_get(h, trace[i]) != NULL) hits++;
+        else hash_put(h, trace[i], item, ITEM_SIZE);
+    }
+    clock_t t1 = clock();
+    printf("  hash-LRU hit %5.1f%% %6.1f ns\n", 100.0 * hits / m,
+           (t1 - t0) * 1e9 / CLOCKS_PER_SEC / m);
+    freeHashLRU(h);
+}
+
+int main() {
+    SplayCache *cache = createCache(3 * sizeof(int), EVICT_LRU);
+    int values[] = {100, 200, 300, 400};
+    for (int i = 0; i < 3; i++)
+        cache_put(cache, i + 1, &values[i], sizeof(int));
+    cache_get(cache, 1);                              // 1 is now most recent
+    cache_put(cache, 4, &values[3], sizeof(int));     // Evicts 2
+    for (long key = 1; key <= 4; key++) {
+        int *v = (int*)cache_get(cache, key);
+        printf("LRU key %ld: %s", key, v ? "" : "miss\n");
+        if (v) printf("%d\n", *v);
+    }
+    freeCache(cache);
+
+    cache = createCache(3 * sizeof(int), EVICT_LFU);
+    for (int i = 0; i < 3; i++)
+        cache_put(cache, i + 1, &values[i], sizeof(int));
+    cache_get(cache, 1);
+    cache_get(cache, 1);
+    cache_get(cache, 3);
+    cache_put(cache, 4, &values[3], sizeof(int));     // Evicts 2 (used once)
+    printf("LFU after put(4): key 2 %s, key 1 %s\n\n",
+           cache_get(cache, 2) ? "kept" : "evicted", cache_get(cache, 1) ? "kept" : "evicted");
+    freeCache(cache);
+
+    int universe = 1000000, m = 2000000;
+    srand(42);
+    long *trace = zipfTrace(universe, m);
+    benchmarkCache(trace, m, universe, 0.001);
+    benchmarkCache(trace, m, universe, 0.01);
+    benchmarkCache(trace, m, universe, 0.1);
+    free(trace);
+    return 0;
+}
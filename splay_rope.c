@@ -0,0 +1,341 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+// Implicit-key splay tree ("rope"): nodes are ordered by position, not by
+// key, and each node stores its subtree size so the k-th element is found
+// by descending on sizes. Sequences are edited with split and merge, so
+// inserting, deleting or updating in the middle costs O(log n) amortized
+// instead of an O(n) memmove.
+//
+// Range add and range reverse are lazy: the tag is stored on the root of
+// the affected subtree and pushed one level down whenever a search passes
+// through a node, so every node a splay rotates is already up to date.
+
+typedef struct RopeNode {
+    long long value;
+    long long sum;          // Sum of values in this subtree
+    int size;               // Number of nodes in this subtree
+    long long add;          // Pending add for both children
+    int reversed;           // Pending reverse for both children
+    struct RopeNode* left;
+    struct RopeNode* right;
+    struct RopeNode* parent;
+} RopeNode;
+
+RopeNode* createRopeNode(long long value) {
+    RopeNode* node = (RopeNode*)malloc(sizeof(RopeNode));
+    node->value = value;
+    node->sum = value;
+    node->size = 1;
+    node->add = 0;
+    node->reversed = 0;
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = NULL;
+    return node;
+}
+
+int size(RopeNode* node) {
+    return node ? node->size : 0;
+}
+
+long long sum(RopeNode* node) {
+    return node ? node->sum : 0;
+}
+
+// --- Lazy tags ---
+
+// Add delta to every element of the subtree rooted at node
+void applyAdd(RopeNode* node, long long delta) {
+    if (node == NULL) return;
+    node->value += delta;
+    node->sum += delta * node->size;
+    node->add += delta;
+}
+
+// Reverse the subtree rooted at node
+void applyReverse(RopeNode* node) {
+    if (node == NULL) return;
+    RopeNode* temp = node->left;
+    node->left = node->right;
+    node->right = temp;
+    node->reversed ^= 1;
+}
+
+// Hand node's pending tags to its children
+void pushDown(RopeNode* node) {
+    if (node->add != 0) {
+        applyAdd(node->left, node->add);
+        applyAdd(node->right, node->add);
+        node->add = 0;
+    }
+    if (node->reversed) {
+        applyReverse(node->left);
+        applyReverse(node->right);
+        node->reversed = 0;
+    }
+}
+
+// Recompute size and sum from the children
+void pull(RopeNode* node) {
+    node->size = 1 + size(node->left) + size(node->right);
+    node->sum = node->value + sum(node->left) + sum(node->right);
+}
+
+// --- Splay ---
+
+// Rotate x above its parent: rightRotate(parent) from splay_tree.c when x
+// is a left child, leftRotate(parent) otherwise, plus the parent links
+// and size/sum updates the rope needs
+void rotate(RopeNode* x) {
+    RopeNode* p = x->parent;
+    RopeNode* g = p->parent;
+
+    if (x == p->left) {
+        p->left = x->right;
+        if (x->right) x->right->parent = p;
+        x->right = p;
+    }
+    else {
+        p->right = x->left;
+        if (x->left) x->left->parent = p;
+        x->left = p;
+    }
+    p->parent = x;
+    x->parent = g;
+    if (g) {
+        if (g->left == p) g->left = x;
+        else g->right = x;
+    }
+
+    pull(p);
+    pull(x);
+}
+
+// Bottom-up splay of x to the root of its tree, without recursion.
+// Tags on the path were pushed by the descent that found x.
+void splay(RopeNode* x) {
+    while (x->parent) {
+        RopeNode* p = x->parent;
+        RopeNode* g = p->parent;
+        if (g) {
+            if ((g->left == p) == (p->left == x))
+                rotate(p); // Zig-zig
+            else
+                rotate(x); // Zig-zag
+        }
+        rotate(x);
+    }
+}
+
+// Splay the k-th (0-based) element of the tree to the root and return it
+RopeNode* splayAt(RopeNode* root, int k) {
+    RopeNode* node = root;
+    while (1) {
+        pushDown(node);
+        int leftSize = size(node->left);
+        if (k < leftSize) {
+            node = node->left;
+        }
+        else if (k == leftSize) {
+            break;
+        }
+        else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+    splay(node);
+    return node;
+}
+
+// --- Split / merge ---
+
+// Concatenate two sequences
+RopeNode* merge(RopeNode* a, RopeNode* b) {
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+    a = splayAt(a, a->size - 1); // Last element has no right child now
+    a->right = b;
+    b->parent = a;
+    pull(a);
+    return a;
+}
+
+// Split root into its first k elements (*left) and the rest (*right)
+void split(RopeNode* root, int k, RopeNode** left, RopeNode** right) {
+    if (k <= 0) {
+        *left = NULL;
+        *right = root;
+        return;
+    }
+    if (k >= size(root)) {
+        *left = root;
+        *right = NULL;
+        return;
+    }
+    root = splayAt(root, k - 1);
+    *right = root->right;
+    (*right)->parent = NULL;
+    root->right = NULL;
+    pull(root);
+    *left = root;
+}
+
+// --- Sequence operations ---
+
+// Balanced rope over arr[lo, hi)
+RopeNode* build(const long long arr[], int lo, int hi) {
+    if (lo >= hi) return NULL;
+    int mid = lo + (hi - lo) / 2;
+    RopeNode* node = createRopeNode(arr[mid]);
+    node->left = build(arr, lo, mid);
+    node->right = build(arr, mid + 1, hi);
+    if (node->left) node->left->parent = node;
+    if (node->right) node->right->parent = node;
+    pull(node);
+    return node;
+}
+
+// Insert value so that it becomes element pos
+RopeNode* insertAt(RopeNode* root, int pos, long long value) {
+    RopeNode *left, *right;
+    split(root, pos, &left, &right);
+    return merge(merge(left, createRopeNode(value)), right);
+}
+
+// Remove element pos
+RopeNode* eraseAt(RopeNode* root, int pos) {
+    RopeNode *left, *mid, *right;
+    split(root, pos, &left, &right);
+    split(right, 1, &mid, &right);
+    free(mid);
+    return merge(left, right);
+}
+
+// Cut out [l, r] as its own tree; the caller must call joinRange afterwards
+static RopeNode* cutRange(RopeNode* root, int l, int r, RopeNode** left, RopeNode** right) {
+    RopeNode* mid;
+    split(root, r + 1, &mid, right);
+    split(mid, l, left, &mid);
+    return mid;
+}
+
+static RopeNode* joinRange(RopeNode* left, RopeNode* mid, RopeNode* right) {
+    return merge(merge(left, mid), right);
+}
+
+// Reverse elements [l, r]
+RopeNode* reverseRange(RopeNode* root, int l, int r) {
+    RopeNode *left, *right;
+    RopeNode* mid = cutRange(root, l, r, &left, &right);
+    applyReverse(mid);
+    return joinRange(left, mid, right);
+}
+
+// Add delta to elements [l, r]
+RopeNode* addRange(RopeNode* root, int l, int r, long long delta) {
+    RopeNode *left, *right;
+    RopeNode* mid = cutRange(root, l, r, &left, &right);
+    applyAdd(mid, delta);
+    return joinRange(left, mid, right);
+}
+
+// Sum of elements [l, r]; the rope is re-rooted, so the new root is returned through *root
+long long sumRange(RopeNode** root, int l, int r) {
+    RopeNode *left, *right;
+    RopeNode* mid = cutRange(*root, l, r, &left, &right);
+    long long result = sum(mid);
+    *root = joinRange(left, mid, right);
+    return result;
+}
+
+// Copy the sequence into out[] (pushing all tags down)
+int toArray(RopeNode* node, long long out[], int pos) {
+    if (node == NULL) return pos;
+    pushDown(node);
+    pos = toArray(node->left, out, pos);
+    out[pos++] = node->value;
+    return toArray(node->right, out, pos);
+}
+
+void freeRope(RopeNode* node) {
+    while (node != NULL) {
+        // Rotate left children up so the walk needs no stack
+        if (node->left != NULL) {
+            RopeNode* l = node->left;
+            node->left = l->right;
+            l->right = node;
+            node = l;
+        }
+        else {
+            RopeNode* next = node->right;
+            free(node);
+            node = next;
+        }
+    }
+}
+
+void printRope(const char* label, RopeNode* root) {
+    long long out[64];
+    int n = toArray(root, out, 0);
+    printf("%-28s", label);
+    for (int i = 0; i < n; i++) printf(" %lld", out[i]);
+    printf("\n");
+}
+
+int main() {
+    long long arr[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    RopeNode* root = build(arr, 0, 8);
+    printRope("Initial:", root);
+
+    root = reverseRange(root, 2, 5);
+    printRope("Reverse [2, 5]:", root);
+
+    root = addRange(root, 0, 3, 10);
+    printRope("Add 10 to [0, 3]:", root);
+
+    root = insertAt(root, 4, 100);
+    printRope("Insert 100 at 4:", root);
+
+    root = eraseAt(root, 0);
+    printRope("Erase at 0:", root);
+
+    printf("Sum [1, 4] = %lld\n", sumRange(&root, 1, 4));
+
+    RopeNode *a, *b;
+    split(root, 3, &a, &b);
+    root = merge(b, a);
+    printRope("Rotate left by 3:", root);
+    freeRope(root);
+
+    // Middle edits: rope vs. array memmove
+    int n = 1000000, edits = 100000;
+    long long* data = (long long*)malloc(sizeof(long long) * (n + edits));
+    for (int i = 0; i < n; i++) data[i] = i;
+    root = build(data, 0, n);
+    srand(42);
+
+    clock_t t0 = clock();
+    for (int i = 0; i < edits; i++) {
+        int pos = rand() % (n + i);
+        root = insertAt(root, pos, i);
+    }
+    clock_t t1 = clock();
+    int len = n;
+    for (int i = 0; i < edits; i++) {
+        int pos = rand() % (len + 1);
+        memmove(&data[pos + 1], &data[pos], sizeof(long long) * (len - pos));
+        data[pos] = i;
+        len++;
+    }
+    clock_t t2 = clock();
+    printf("\n%d inserts into %d elements: rope %.1f ns/op, memmove %.1f ns/op\n", edits, n,
+           (t1 - t0) * 1e9 / CLOCKS_PER_SEC / edits, (t2 - t1) * 1e9 / CLOCKS_PER_SEC / edits);
+
+    freeRope(root);
+    free(data);
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include<stdio.h>
 #include<stdlib.h>
+#include<time.h>
 typedef struct TreeNode {
     int data;
     struct TreeNode* left;
@@ -155,9 +156,6 @@ tnode *insertSplay(tnode *root, int data) {
     return root;
 }
 
-tnode *root = NULL;
-
-
 tnode *deleteSplay(tnode *root, int data) {
     if (root == NULL) {
         return NULL;
@@ -187,7 +185,345 @@ tnode *deleteSplay(tnode *root, int data) {
     }
 }
 
+// Top-down splay (Sleator & Tarjan): splits the tree into left and right
+// pieces while walking down from the root, so the whole splay is one
+// loop with no recursion and no second pass. The zig-zig step rotates
+// before linking; zig-zag and zig simply link.
+tnode *topDownSplay(tnode *root, int data) {
+    if (root == NULL) return NULL;
+
+    tnode header = {0, NULL, NULL};
+    tnode *leftMax = &header;   // Largest node of the left piece
+    tnode *rightMin = &header;  // Smallest node of the right piece
+
+    while (1) {
+        if (data < root->data) {
+            if (root->left == NULL) break;
+            if (data < root->left->data) {
+                root = rightRotate(root); // Zig-zig
+                if (root->left == NULL) break;
+            }
+            rightMin->left = root; // Link right
+            rightMin = root;
+            root = root->left;
+        }
+        else if (data > root->data) {
+            if (root->right == NULL) break;
+            if (data > root->right->data) {
+                root = leftRotate(root); // Zig-zig
+                if (root->right == NULL) break;
+            }
+            leftMax->right = root; // Link left
+            leftMax = root;
+            root = root->right;
+        }
+        else {
+            break;
+        }
+    }
+
+    // Reassemble
+    leftMax->right = root->left;
+    rightMin->left = root->right;
+    root->left = header.right;
+    root->right = header.left;
+    return root;
+}
+
+// Top-down splay of the maximum: the data > root->data branch of
+// topDownSplay with data = +infinity, so duplicates cannot stop it early
+tnode *splayMax(tnode *root) {
+    if (root == NULL) return NULL;
+
+    tnode header = {0, NULL, NULL};
+    tnode *leftMax = &header;
+
+    while (root->right != NULL) {
+        if (root->right->right != NULL) {
+            root = leftRotate(root); // Zig-zig
+        }
+        leftMax->right = root; // Link left
+        leftMax = root;
+        root = root->right;
+    }
+
+    leftMax->right = root->left;
+    root->left = header.right;
+    return root;
+}
+
+// Insert with one splay: splay the closest key to the root, then split
+// the tree around it under the new node
+tnode *insertTopDown(tnode *root, int data) {
+    tnode *newNode = createTreeNode(data);
+    if (root == NULL) return newNode;
+
+    root = topDownSplay(root, data);
+    if (data < root->data) {
+        newNode->left = root->left;
+        newNode->right = root;
+        root->left = NULL;
+    }
+    else {
+        newNode->right = root->right;
+        newNode->left = root;
+        root->right = NULL;
+    }
+    return newNode;
+}
+
+// Delete with one splay: bring the key to the root, then join its
+// subtrees by splaying the left one's maximum to its root
+tnode *deleteTopDown(tnode *root, int data) {
+    if (root == NULL) return NULL;
+
+    root = topDownSplay(root, data);
+    if (root->data != data) return root;
+
+    tnode *newRoot;
+    if (root->left == NULL) {
+        newRoot = root->right;
+    }
+    else {
+        newRoot = splayMax(root->left); // Max has no right child
+        newRoot->right = root->right;
+    }
+    free(root);
+    return newRoot;
+}
+
+tnode *searchTopDown(tnode *root, int data) {
+    return topDownSplay(root, data);
+}
+
+void freeTree(tnode *root) {
+    while (root != NULL) {
+        // Rotate left children up so the walk needs no stack
+        if (root->left != NULL) {
+            root = rightRotate(root);
+        }
+        else {
+            tnode *next = root->right;
+            free(root);
+            root = next;
+        }
+    }
+}
+
+// How a search restructures the tree. Inserts and deletes always use the
+// full top-down splay; the mode only changes what a read does.
+typedef enum {
+    SPLAY_FULL,     // Splay the found node to the root (the classic rule)
+    SPLAY_SEMI,     // Semi-splay: a zig-zig only lifts the parent, halving the path
+    SPLAY_DEPTH,    // Full splay only when the node is deeper than param
+    SPLAY_EVERY_K   // Full splay only on every param-th search
+} SplayMode;
+
+// Handle for one splay tree, so a program can keep several independent
+// trees. Every access (searches included) restructures the tree, so a
+// handle must only be used by one thread at a time: give each thread its
+// own trees, or see sharded_splay.c for sharing one key space.
+typedef struct {
+    tnode *root;
+    int size;
+    SplayMode mode;
+    int param;              // Depth threshold or k, depending on mode
+    tnode ***path;          // Child-pointer slots along the last search path
+    int pathCap;
+
+    // Search counters, for comparing modes on a real trace
+    long long searches;
+    long long rotations;
+    long long totalDepth;   // Sum of access depths (root = 0)
+} SplayTree;
+
+SplayTree *createSplayTree() {
+    SplayTree *tree = (SplayTree*)malloc(sizeof(SplayTree));
+    tree->root = NULL;
+    tree->size = 0;
+    tree->mode = SPLAY_FULL;
+    tree->param = 0;
+    tree->pathCap = 64;
+    tree->path = (tnode***)malloc(sizeof(tnode**) * tree->pathCap);
+    tree->searches = tree->rotations = tree->totalDepth = 0;
+    return tree;
+}
+
+// Returns 0, or -1 (leaving the mode unchanged) if param is out of range:
+// SPLAY_EVERY_K needs k >= 1 and SPLAY_DEPTH a threshold >= 0
+int splayTreeSetMode(SplayTree *tree, SplayMode mode, int param) {
+    if ((mode == SPLAY_EVERY_K && param < 1) || (mode == SPLAY_DEPTH && param < 0))
+        return -1;
+    tree->mode = mode;
+    tree->param = param;
+    return 0;
+}
+
+void splayTreeResetStats(SplayTree *tree) {
+    tree->searches = tree->rotations = tree->totalDepth = 0;
+}
+
+void splayTreeInsert(SplayTree *tree, int data) {
+    tree->root = insertTopDown(tree->root, data);
+    tree->size++;
+}
+
+// Rotate the child in *slot up over the node in *slot
+static void rotateUp(SplayTree *tree, tnode **slot, tnode *child) {
+    *slot = (child == (*slot)->left) ? rightRotate(*slot) : leftRotate(*slot);
+    tree->rotations++;
+}
+
+// Bottom-up (semi-)splay of the node at path[depth]. path[i] is the slot
+// holding the node at depth i, and rotations below path[i] never move
+// that slot, so the recorded path stays valid as the node climbs.
+static void splayPath(SplayTree *tree, int depth, int semi) {
+    tnode ***path = tree->path;
+    while (depth >= 2) {
+        tnode *x = *path[depth];
+        tnode *p = *path[depth - 1];
+        tnode *g = *path[depth - 2];
+        if ((p == g->left) == (x == p->left)) {
+            rotateUp(tree, path[depth - 2], p);     // Zig-zig: parent first
+            if (!semi) rotateUp(tree, path[depth - 2], x);
+            // Semi-splay carries on from p, now at depth - 2
+        }
+        else {
+            rotateUp(tree, path[depth - 1], x);     // Zig-zag
+            rotateUp(tree, path[depth - 2], x);
+        }
+        depth -= 2;
+    }
+    if (depth == 1)
+        rotateUp(tree, path[0], *path[1]);          // Zig
+}
+
+// Returns 1 if data is in the tree. The node where the search ends (data,
+// or the last node visited) is splayed according to the tree's mode.
+int splayTreeContains(SplayTree *tree, int data) {
+    if (tree->root == NULL) return 0;
+
+    int depth = 0;
+    tree->path[0] = &tree->root;
+    while (1) {
+        tnode *node = *tree->path[depth];
+        tnode **next = (data < node->data) ? &node->left : &node->right;
+        if (node->data == data || *next == NULL) break;
+        if (depth + 1 == tree->pathCap) {
+            tree->pathCap *= 2;
+            tree->path = (tnode***)realloc(tree->path, sizeof(tnode**) * tree->pathCap);
+        }
+        tree->path[++depth] = next;
+    }
+    int found = (*tree->path[depth])->data == data;
+
+    tree->searches++;
+    tree->totalDepth += depth;
+    switch (tree->mode) {
+    case SPLAY_FULL:
+        splayPath(tree, depth, 0);
+        break;
+    case SPLAY_SEMI:
+        splayPath(tree, depth, 1);
+        break;
+    case SPLAY_DEPTH:
+        if (depth > tree->param) splayPath(tree, depth, 0);
+        break;
+    case SPLAY_EVERY_K:
+        if (tree->searches % tree->param == 0) splayPath(tree, depth, 0);
+        break;
+    }
+    return found;
+}
+
+// Remove one copy of data; returns 1 if one was found
+int splayTreeDelete(SplayTree *tree, int data) {
+    tree->root = topDownSplay(tree->root, data);
+    if (tree->root == NULL || tree->root->data != data) return 0;
+    tree->root = deleteTopDown(tree->root, data); // Already at the root
+    tree->size--;
+    return 1;
+}
+
+void freeSplayTree(SplayTree *tree) {
+    freeTree(tree->root);
+    free(tree->path);
+    free(tree);
+}
+
+// Zipf(s = 1) ranks drawn from a precomputed CDF
+int *zipfTrace(int n, int m) {
+    double *cdf = (double*)malloc(sizeof(double) * n);
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += 1.0 / (i + 1);
+        cdf[i] = sum;
+    }
+    int *trace = (int*)malloc(sizeof(int) * m);
+    for (int i = 0; i < m; i++) {
+        double u = (double)rand() / RAND_MAX * sum;
+        int lo = 0, hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        trace[i] = lo;
+    }
+    free(cdf);
+    return trace;
+}
+
+// Build from keys, then search every key of the trace; reports ns/op for
+// the recursive bottom-up version and the top-down version. n is kept
+// small enough that the recursive splay does not overflow the stack.
+void benchmarkSplay(const char *label, int *keys, int n, int *trace, int m) {
+    tnode *a = NULL, *b = NULL;
+    clock_t t0 = clock();
+    for (int i = 0; i < n; i++) a = insertSplay(a, keys[i]);
+    clock_t t1 = clock();
+    for (int i = 0; i < m; i++) a = search(a, trace[i]);
+    clock_t t2 = clock();
+    for (int i = 0; i < n; i++) b = insertTopDown(b, keys[i]);
+    clock_t t3 = clock();
+    for (int i = 0; i < m; i++) b = searchTopDown(b, trace[i]);
+    clock_t t4 = clock();
+
+    double ns = 1e9 / CLOCKS_PER_SEC;
+    printf("%-10s insert: bottom-up %6.1f ns, top-down %6.1f ns | search: bottom-up %6.1f ns, top-down %6.1f ns\n",
+           label, (t1 - t0) * ns / n, (t3 - t2) * ns / n, (t2 - t1) * ns / m, (t4 - t3) * ns / m);
+    freeTree(a);
+    freeTree(b);
+}
+
+// Search trace under each splay mode: time per search plus the counters
+void benchmarkModes(const char *label, int *keys, int n, int *trace, int m) {
+    struct { const char *name; SplayMode mode; int param; } configs[] = {
+        {"full", SPLAY_FULL, 0}, {"semi", SPLAY_SEMI, 0},
+        {"depth > 20", SPLAY_DEPTH, 20}, {"depth > 30", SPLAY_DEPTH, 30},
+        {"every 4th", SPLAY_EVERY_K, 4}, {"every 16th", SPLAY_EVERY_K, 16},
+    };
+    printf("%s trace:\n", label);
+    for (int c = 0; c < 6; c++) {
+        SplayTree *tree = createSplayTree();
+        for (int i = 0; i < n; i++) splayTreeInsert(tree, keys[i]);
+        splayTreeSetMode(tree, configs[c].mode, configs[c].param);
+        splayTreeResetStats(tree);
+
+        clock_t t0 = clock();
+        int hits = 0;
+        for (int i = 0; i < m; i++) hits += splayTreeContains(tree, trace[i]);
+        clock_t t1 = clock();
+
+        printf("  %-11s %6.1f ns/search, %5.2f rotations/search, average depth %5.2f (hits %d)\n",
+               configs[c].name, (t1 - t0) * 1e9 / CLOCKS_PER_SEC / m,
+               (double)tree->rotations / tree->searches, (double)tree->totalDepth / tree->searches, hits);
+        freeSplayTree(tree);
+    }
+}
+
 int main() {
+    tnode *root = NULL;
     root = insertSplay(root, 10);
     root = insertSplay(root, 4);
     root = insertSplay(root, 5);
@@ -196,4 +532,61 @@ int main() {
     root = insertSplay(root, 1);
 
     inOrder(root);
+    printf("\n");
+    freeTree(root);
+
+    // Same operations with the one-pass top-down splay
+    tnode *td = NULL;
+    int values[] = {10, 4, 5, 2, 1, 1};
+    for (int i = 0; i < 6; i++)
+        td = insertTopDown(td, values[i]);
+    td = deleteTopDown(td, 4);
+    inOrder(td);
+    printf(" (top-down, 4 deleted)\n");
+    freeTree(td);
+
+    // Two independent trees through handles
+    SplayTree *evens = createSplayTree();
+    SplayTree *odds = createSplayTree();
+    for (int i = 0; i < 10; i++)
+        splayTreeInsert(i % 2 ? odds : evens, i);
+    splayTreeDelete(evens, 4);
+    printf("evens: size %d, contains(4) = %d | odds: size %d, contains(7) = %d\n",
+           evens->size, splayTreeContains(evens, 4), odds->size, splayTreeContains(odds, 7));
+    printf("every 0th search: %d\n\n", splayTreeSetMode(evens, SPLAY_EVERY_K, 0));
+    freeSplayTree(evens);
+    freeSplayTree(odds);
+
+    // Benchmark: sequential, uniform and Zipfian access
+    int n = 100000, m = 1000000;
+    int *keys = (int*)malloc(sizeof(int) * n);
+    int *trace = (int*)malloc(sizeof(int) * m);
+    srand(42);
+
+    for (int i = 0; i < n; i++) keys[i] = i;
+    for (int i = 0; i < m; i++) trace[i] = i % n;
+    benchmarkSplay("sequential", keys, n, trace, m);
+
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int t = keys[i]; keys[i] = keys[j]; keys[j] = t;
+    }
+    for (int i = 0; i < m; i++) trace[i] = rand() % n;
+    benchmarkSplay("uniform", keys, n, trace, m);
+    int *uniform = (int*)malloc(sizeof(int) * m);
+    for (int i = 0; i < m; i++) uniform[i] = trace[i];
+
+    int *ranks = zipfTrace(n, m);
+    for (int i = 0; i < m; i++) trace[i] = keys[ranks[i]]; // Hot keys scattered over the key space
+    benchmarkSplay("zipf", keys, n, trace, m);
+
+    printf("\nSearch modes, %d keys:\n", n);
+    benchmarkModes("uniform", keys, n, uniform, m);
+    benchmarkModes("zipf", keys, n, trace, m);
+    free(uniform);
+
+    free(ranks);
+    free(keys);
+    free(trace);
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// Static wavelet tree for order statistics on a range: "k-th smallest
+// value in arr[L..R]" and "how many values in arr[L..R] are <= x", each
+// in O(log sigma), where sigma is the number of distinct values.
+//
+// The values are first replaced by their rank among the distinct values
+// (codes 0..sigma-1), and the codes are stored one bit plane at a time,
+// most significant bit first. This is the "wavelet matrix" layout: each
+// level is a single bit vector over all n positions, stably partitioned
+// with the 0s of the previous level in front of the 1s, instead of one
+// node per value range. There are no node pointers, and the whole
+// structure is ceil(log2 sigma) * n bits plus a rank directory of one
+// 32-bit count per 64-bit word (1.5 bits per element per level), plus
+// the sigma distinct values that map codes back to values.
+
+typedef struct {
+    uint64_t* bits;   // Bit i is position i's bit at this level
+    uint32_t* ranks;  // ranks[w] = number of 1s in bits[0, w)
+    int zeros;        // Number of 0s at this level: where the 1s start below
+} BitLevel;
+
+typedef struct {
+    BitLevel* levels;
+    int numLevels;
+    int* values;      // The distinct values, sorted; code c stands for values[c]
+    int sigma;        // Number of distinct values
+    int n;            // Size of the original input array
+} WaveletTree;
+
+/**
+ * @brief Number of 1s in bits[0, i).
+ */
+static inline int rank1(const BitLevel* level, int i) {
+    uint64_t word = level->bits[i >> 6] & ((1ULL << (i & 63)) - 1);
+    return (int)level->ranks[i >> 6] + __builtin_popcountll(word);
+}
+
+/**
+ * @brief Number of 0s in bits[0, i).
+ */
+static inline int rank0(const BitLevel* level, int i) {
+    return i - rank1(level, i);
+}
+
+static int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Number of distinct values strictly less than x, i.e. the code
+ *        x would get.
+ */
+static int codeOf(const WaveletTree* wt, int x) {
+    int lo = 0, hi = wt->sigma;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (wt->values[mid] < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Builds the wavelet tree in O(n log sigma) after an O(n log n) sort.
+ * @param arr The input array
+ * @param n Size of the input array
+ * @return A new, initialized WaveletTree
+ */
+WaveletTree createWaveletTree(int arr[], int n) {
+    WaveletTree wt;
+    wt.n = n;
+
+    // Distinct values, sorted
+    wt.values = (int*)malloc(sizeof(int) * n);
+    int* codes = (int*)malloc(sizeof(int) * n);
+    int* next = (int*)malloc(sizeof(int) * n);
+    if (wt.values == NULL || codes == NULL || next == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    memcpy(wt.values, arr, sizeof(int) * n);
+    qsort(wt.values, n, sizeof(int), compareInts);
+    wt.sigma = 0;
+    for (int i = 0; i < n; i++) {
+        if (wt.sigma == 0 || wt.values[wt.sigma - 1] != wt.values[i]) {
+            wt.values[wt.sigma++] = wt.values[i];
+        }
+    }
+    int* shrunk = (int*)realloc(wt.values, sizeof(int) * wt.sigma);
+    if (shrunk != NULL) {
+        wt.values = shrunk;
+    }
+    for (int i = 0; i < n; i++) {
+        codes[i] = codeOf(&wt, arr[i]);
+    }
+
+    wt.numLevels = 1;
+    while ((1 << wt.numLevels) < wt.sigma) {
+        wt.numLevels++;
+    }
+    wt.levels = (BitLevel*)malloc(sizeof(BitLevel) * wt.numLevels);
+    int words = n / 64 + 1; // One spare word, so rank1(level, n) stays in bounds
+
+    for (int d = 0; d < wt.numLevels; d++) {
+        BitLevel* level = &wt.levels[d];
+        int bit = wt.numLevels - 1 - d;
+        level->bits = (uint64_t*)calloc(words, sizeof(uint64_t));
+        level->ranks = (uint32_t*)malloc(sizeof(uint32_t) * words);
+        if (level->bits == NULL || level->ranks == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+
+        // Record this bit of every code, then stably move the 0s in front
+        int zeros = 0;
+        for (int i = 0; i < n; i++) {
+            if ((codes[i] >> bit) & 1) {
+                level->bits[i >> 6] |= 1ULL << (i & 63);
+            } else {
+                zeros++;
+            }
+        }
+        level->zeros = zeros;
+        int z = 0, o = zeros;
+        for (int i = 0; i < n; i++) {
+            if ((codes[i] >> bit) & 1) next[o++] = codes[i];
+            else next[z++] = codes[i];
+        }
+        int* tmp = codes;
+        codes = next;
+        next = tmp;
+
+        uint32_t count = 0;
+        for (int w = 0; w < words; w++) {
+            level->ranks[w] = count;
+            count += __builtin_popcountll(level->bits[w]);
+        }
+    }
+
+    free(codes);
+    free(next);
+    return wt;
+}
+
+/**
+ * @brief k-th smallest value in arr[L..R], counting from k = 1.
+ * @return The value, or -1 on invalid arguments
+ */
+int waveletKth(WaveletTree* wt, int L, int R, int k) {
+    if (L < 0 || R > wt->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    if (k < 1 || k > R - L + 1) {
+        fprintf(stderr, "Invalid rank k\n");
+        return -1;
+    }
+    // Follow the positions [l, r) of the range down the levels
+    int l = L, r = R + 1, code = 0;
+    k--;
+    for (int d = 0; d < wt->numLevels; d++) {
+        const BitLevel* level = &wt->levels[d];
+        int l1 = rank1(level, l), r1 = rank1(level, r);
+        int zeros = (r - l) - (r1 - l1);
+        if (k < zeros) {
+            // Answer has a 0 here: go to the 0 part of the next level
+            l -= l1;
+            r -= r1;
+            code <<= 1;
+        } else {
+            k -= zeros;
+            l = level->zeros + l1;
+            r = level->zeros + r1;
+            code = (code << 1) | 1;
+        }
+    }
+    return wt->values[code];
+}
+
+/**
+ * @brief Number of values <= x in arr[L..R].
+ * @return The count, or -1 on an invalid range
+ */
+int waveletCountLessEqual(WaveletTree* wt, int L, int R, int x) {
+    if (L < 0 || R > wt->n - 1 || L > R) {
+        fprintf(stderr, "Invalid query range\n");
+        return -1;
+    }
+    // Values <= x are exactly the codes < c
+    int c = codeOf(wt, x);
+    if (c < wt->sigma && wt->values[c] == x) {
+        c++;
+    }
+    if (c == wt->sigma) {
+        return R - L + 1;
+    }
+    // Walk c's path; whenever c has a 1, everything in the 0 branch is smaller
+    int l = L, r = R + 1, count = 0;
+    for (int d = 0; d < wt->numLevels; d++) {
+        const BitLevel* level = &wt->levels[d];
+        int bit = wt->numLevels - 1 - d;
+        int l1 = rank1(level, l), r1 = rank1(level, r);
+        if ((c >> bit) & 1) {
+            count += (r - l) - (r1 - l1);
+            l = level->zeros + l1;
+            r = level->zeros + r1;
+        } else {
+            l -= l1;
+            r -= r1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Frees all allocated memory for the wavelet tree.
+ */
+void freeWaveletTree(WaveletTree* wt) {
+    for (int d = 0; d < wt->numLevels; d++) {
+        free(wt->levels[d].bits);
+        free(wt->levels[d].ranks);
+    }
+    free(wt->levels);
+    free(wt->values);
+    wt->levels = NULL;
+    wt->values = NULL;
+    wt->numLevels = wt->sigma = wt->n = 0;
+}
+
+/**
+ * @brief The current approach: copy arr[L..R], sort it, pick index k - 1.
+ */
+int copySortKth(int arr[], int* scratch, int L, int R, int k) {
+    memcpy(scratch, arr + L, sizeof(int) * (R - L + 1));
+    qsort(scratch, R - L + 1, sizeof(int), compareInts);
+    return scratch[k - 1];
+}
+
+// --- Example Usage ---
+int main() {
+    int arr[] = {5, 1, 9, 3, 7, 3, 8, 2};
+    int n = sizeof(arr) / sizeof(arr[0]);
+
+    WaveletTree wt = createWaveletTree(arr, n);
+
+    // arr[1..5] = {1, 9, 3, 7, 3}, sorted {1, 3, 3, 7, 9}
+    printf("2nd smallest in [1, 5]: %d\n", waveletKth(&wt, 1, 5, 2));       // 3
+    printf("Median of [1, 5]: %d\n", waveletKth(&wt, 1, 5, 3));             // 3
+    printf("Largest in [0, 7]: %d\n", waveletKth(&wt, 0, 7, 8));            // 9
+    printf("Values <= 6 in [1, 5]: %d\n", waveletCountLessEqual(&wt, 1, 5, 6)); // 3
+    printf("Values <= 0 in [0, 7]: %d\n", waveletCountLessEqual(&wt, 0, 7, 0)); // 0
+    printf("%d distinct values, %d levels\n\n", wt.sigma, wt.numLevels);
+    freeWaveletTree(&wt);
+
+    // Random ranges: wavelet tree vs. copying and sorting each range
+    int size = 1000000, queries = 1000000, sortQueries = 20;
+    int* values = (int*)malloc(sizeof(int) * size);
+    int* scratch = (int*)malloc(sizeof(int) * size);
+    int* Ls = (int*)malloc(sizeof(int) * queries);
+    int* Rs = (int*)malloc(sizeof(int) * queries);
+    int* ks = (int*)malloc(sizeof(int) * queries);
+    srand(42);
+    for (int i = 0; i < size; i++) values[i] = rand();
+    for (int q = 0; q < queries; q++) {
+        int a = rand() % size, b = rand() % size;
+        Ls[q] = a < b ? a : b;
+        Rs[q] = a < b ? b : a;
+        ks[q] = 1 + rand() % (Rs[q] - Ls[q] + 1);
+    }
+
+    clock_t t0 = clock();
+    wt = createWaveletTree(values, size);
+    clock_t t1 = clock();
+    long long checksum = 0;
+    for (int q = 0; q < queries; q++) checksum += waveletKth(&wt, Ls[q], Rs[q], ks[q]);
+    clock_t t2 = clock();
+    for (int q = 0; q < queries; q++) checksum += waveletCountLessEqual(&wt, Ls[q], Rs[q], values[ks[q] % size]);
+    clock_t t3 = clock();
+
+    // Sorting a range of ~n/3 elements takes tens of ms, so a few queries do
+    int mismatches = 0;
+    clock_t t4 = clock();
+    for (int q = 0; q < sortQueries; q++) {
+        mismatches += copySortKth(values, scratch, Ls[q], Rs[q], ks[q]) != waveletKth(&wt, Ls[q], Rs[q], ks[q]);
+    }
+    clock_t t5 = clock();
+
+    double ns = 1e9 / CLOCKS_PER_SEC;
+    size_t bytes = (size_t)wt.sigma * sizeof(int); // The distinct values
+    for (int d = 0; d < wt.numLevels; d++) {
+        bytes += (size_t)(size / 64 + 1) * (sizeof(uint64_t) + sizeof(uint32_t));
+    }
+    printf("n = %d, %d distinct values, %d levels, %.1f MB (%.1f bits per element)\n",
+           size, wt.sigma, wt.numLevels, bytes / 1048576.0, bytes * 8.0 / size);
+    printf("Build: %.1f ms\n", (t1 - t0) * ns / 1e6);
+    printf("k-th smallest: %.1f ns/query, count <= x: %.1f ns/query (checksum %lld)\n",
+           (t2 - t1) * ns / queries, (t3 - t2) * ns / queries, checksum);
+    printf("Copy and sort: %.1f us/query%s\n", (t5 - t4) * ns / 1e3 / sortQueries,
+           mismatches == 0 ? "" : " (MISMATCH)");
+
+    freeWaveletTree(&wt);
+    free(values);
+    free(scratch);
+    free(Ls);
+    free(Rs);
+    free(ks);
+    return 0;
+}